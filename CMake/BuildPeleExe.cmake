@@ -33,6 +33,8 @@ function(build_pele_exe pele_exe_name pele_physics_lib_name)
        ${SRC_DIR}/Advance.cpp
        ${SRC_DIR}/BCfill.cpp
        ${SRC_DIR}/Bld.cpp
+       ${SRC_DIR}/ChemCache.H
+       ${SRC_DIR}/ChemCache.cpp
        ${SRC_DIR}/Constants.H
        ${SRC_DIR}/Derive.H
        ${SRC_DIR}/Derive.cpp
@@ -58,20 +60,31 @@ function(build_pele_exe pele_exe_name pele_physics_lib_name)
        ${SRC_DIR}/IndexDefines.H
        ${SRC_DIR}/IO.H
        ${SRC_DIR}/IO.cpp
+       ${SRC_DIR}/IMEX.H
+       ${SRC_DIR}/IMEX.cpp
        ${SRC_DIR}/LES.H
        ${SRC_DIR}/LES.cpp
        ${SRC_DIR}/MOL.H
        ${SRC_DIR}/MOL.cpp
+       ${SRC_DIR}/Parareal.H
+       ${SRC_DIR}/Parareal.cpp
        ${SRC_DIR}/PeleC.H
        ${SRC_DIR}/PeleC.cpp
        ${SRC_DIR}/PeleCAmr.H
        ${SRC_DIR}/PeleCAmr.cpp
+       ${SRC_DIR}/PrimCache.cpp
        ${SRC_DIR}/ProblemSpecificFunctions.H
+       ${SRC_DIR}/React.H
        ${SRC_DIR}/React.cpp
        ${SRC_DIR}/Riemann.H
+       ${SRC_DIR}/ScratchArena.H
+       ${SRC_DIR}/ScratchArena.cpp
        ${SRC_DIR}/Setup.cpp
        ${SRC_DIR}/Sources.cpp
        ${SRC_DIR}/SparseData.H
+       ${SRC_DIR}/StateReduce.H
+       ${SRC_DIR}/MOLRK.H
+       ${SRC_DIR}/DtControl.H
        ${SRC_DIR}/SumIQ.cpp
        ${SRC_DIR}/SumUtils.cpp
        ${SRC_DIR}/Tagging.H
@@ -10,7 +10,7 @@ set(AMReX_FORTRAN OFF)
 set(AMReX_FORTRAN_INTERFACES OFF)
 set(AMReX_PIC OFF)
 set(AMReX_PRECISION "${PELE_PRECISION}" CACHE STRING "Floating point precision" FORCE)
-set(AMReX_LINEAR_SOLVERS OFF)
+set(AMReX_LINEAR_SOLVERS ON)
 set(AMReX_AMRDATA OFF)
 set(AMReX_ASCENT ${PELE_ENABLE_ASCENT})
 set(AMReX_SENSEI OFF)
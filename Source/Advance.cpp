@@ -32,11 +32,130 @@ PeleC::advance(
     }
   }
 
+  // The primitive variable cache lives within a level advance
+  clear_prim_cache();
+  amrex::Real dt_new;
+  if (step_retries > 0) {
+    dt_new = advance_with_retries(time, dt, amr_iteration, amr_ncycle);
+  } else {
+    dt_new = advance_step(time, dt, amr_iteration, amr_ncycle);
+  }
+  clear_prim_cache();
+
+  return dt_new;
+}
+
+amrex::Real
+PeleC::advance_step(
+  amrex::Real time, amrex::Real dt, int amr_iteration, int amr_ncycle)
+{
   amrex::Real dt_new;
   if (do_mol) {
     dt_new = do_mol_advance(time, dt, amr_iteration, amr_ncycle);
   } else {
-    dt_new = do_sdc_advance(time, dt, amr_iteration, amr_ncycle);
+    dt_new = do_sdc_advance(time, dt, amr_iteration, amr_ncycle, sdc_iters);
+  }
+
+  return dt_new;
+}
+
+amrex::Real
+PeleC::advance_propagator(
+  amrex::Real time, amrex::Real dt, int nsweeps, bool coarse)
+{
+  BL_PROFILE("PeleC::advance_propagator()");
+
+  const bool swap_reactor = coarse && reactor_coarse;
+  if (swap_reactor) {
+    std::swap(reactor, reactor_coarse);
+  }
+  clear_prim_cache();
+  const amrex::Real dt_new = do_sdc_advance(time, dt, 1, 1, nsweeps);
+  clear_prim_cache();
+  if (swap_reactor) {
+    std::swap(reactor, reactor_coarse);
+  }
+
+  return dt_new;
+}
+
+amrex::Real
+PeleC::advance_with_retries(
+  amrex::Real time, amrex::Real dt, int amr_iteration, int amr_ncycle)
+{
+  BL_PROFILE("PeleC::advance_with_retries()");
+
+  // Copy of the level at the start of the step: the new data and time of
+  // each state type and the flux register data the advance adds to
+  amrex::Vector<amrex::MultiFab> S_start(num_state_type);
+  amrex::Vector<amrex::Real> t_cur(num_state_type);
+  amrex::Vector<amrex::Real> t_prev(num_state_type);
+  for (int i = 0; i < num_state_type; ++i) {
+    const amrex::MultiFab& S = get_new_data(i);
+    S_start[i].define(
+      S.boxArray(), S.DistributionMap(), S.nComp(), S.nGrow(), amrex::MFInfo(),
+      Factory());
+    amrex::MultiFab::Copy(S_start[i], S, 0, 0, S.nComp(), S.nGrow());
+    t_cur[i] = state[i].curTime();
+    t_prev[i] = state[i].prevTime();
+  }
+  amrex::Vector<amrex::MultiFab> flux_reg_start;
+  save_flux_registers(flux_reg_start);
+
+  amrex::Real dt_new = dt;
+  int nsub = 1;
+  for (int retry = 0;; ++retry) {
+    const amrex::Real dt_sub = dt / nsub;
+    bool failed = false;
+    for (int n = 0; (n < nsub) && !failed; ++n) {
+      step_failed = false;
+      dt_new =
+        advance_step(time + n * dt_sub, dt_sub, amr_iteration, amr_ncycle);
+      const amrex::MultiFab& S_new = get_new_data(State_Type);
+      failed = step_failed || S_new.contains_nan(0, NVAR, 0, true) ||
+               S_new.contains_inf(0, NVAR, 0, true);
+      amrex::ParallelDescriptor::ReduceBoolOr(failed);
+    }
+    step_failed = false;
+    if (!failed) {
+      break;
+    }
+
+    if (retry == step_retries) {
+      amrex::Abort(
+        "Level " + std::to_string(level) + " advance failed after " +
+        std::to_string(step_retries) + " retries");
+    }
+
+    nsub *= step_retry_factor;
+    amrex::Print() << "WARNING -- level " << level << " advance from time "
+                   << time << " failed (CFL above 1 or NaN/Inf in the state),"
+                   << " retry " << retry + 1 << " of " << step_retries
+                   << " with " << nsub << " substeps of " << dt / nsub
+                   << '\n';
+
+    for (int i = 0; i < num_state_type; ++i) {
+      amrex::MultiFab& S = get_new_data(i);
+      amrex::MultiFab::Copy(S, S_start[i], 0, 0, S.nComp(), S.nGrow());
+      state[i].setTimeLevel(t_cur[i], t_cur[i] - t_prev[i], 0.0);
+    }
+    restore_flux_registers(flux_reg_start);
+  }
+
+  DtControl& ctrl = level_dt_control();
+  ctrl.substeps = amrex::max(ctrl.substeps, nsub);
+
+  // After substeps, the old data is the state at the last substep. Point it
+  // back to the start of the step, for the fine levels to interpolate in
+  // time between the start and the end of the step.
+  if (nsub > 1) {
+    for (int i = 0; i < num_state_type; ++i) {
+      if ((i != Reactions_Type) || (!do_react)) {
+        amrex::MultiFab& S = get_old_data(i);
+        amrex::MultiFab::Copy(S, S_start[i], 0, 0, S.nComp(), S.nGrow());
+        state[i].setTimeLevel(time + dt, dt, 0.0);
+      }
+    }
   }
 
   return dt_new;
@@ -83,11 +202,6 @@ PeleC::do_mol_advance(
   set_body_state(S_old);
   set_body_state(S_new);
 
-  // Compute S^{n} = MOLRhs(U^{n})
-  if (verbose != 0) {
-    amrex::Print() << "... Computing MOL source term at t^{n} " << std::endl;
-  }
-
   int nGrow_FP_border = numGrow() + nGrowF;
 #ifdef PELE_USE_SPRAY
   const int spray_state_ghosts = sprayStateGhosts(amr_ncycle);
@@ -95,89 +209,174 @@ PeleC::do_mol_advance(
   AMREX_ASSERT(Sborder.nGrow() >= nGrow_FP_border);
 #endif
 
-  FillPatcherFill(Sborder, 0, NVAR, nGrow_FP_border, time, State_Type, 0);
-  amrex::Real reflux_factor = 0.5;
-  getMOLSrcTerm(Sborder, molSrc, time, dt, reflux_factor);
+  if (imex_acoustic) {
+    do_imex_advance(
+      time, dt, amr_iteration, amr_ncycle, molSrc, nGrow_FP_border);
+    set_body_state(S_new);
+    return dt;
+  }
 
-  // Build other (non-diffusion) sources at t_old
-  for (int src : src_list) {
-    if (src != diff_src) {
-      construct_old_source(src, time, dt, amr_iteration, amr_ncycle, 0, 0);
+  if ((mol_rk.name != "ssprk2") || diffusion_sts) {
+    do_mol_rk_advance(
+      time, dt, amr_iteration, amr_ncycle, molSrc, nGrow_FP_border);
+    set_body_state(S_new);
+    return dt;
+  }
 
-      // add sources to molsrc
-      amrex::MultiFab::Saxpy(molSrc, 1.0, *old_sources[src], 0, 0, NVAR, 0);
-    }
+  // Compute S^{n} = MOLRhs(U^{n})
+  if (verbose != 0) {
+    amrex::Print() << "... Computing MOL source term at t^{n} " << std::endl;
   }
 
-  if (mol_iters > 1) {
-    amrex::MultiFab::Copy(molSrc_old, molSrc, 0, 0, NVAR, 0);
+  // Deep halo: the predictor is also computed on nGrow_FP_border ghost
+  // cells, from a halo twice as deep, which leaves Sborder filled for the
+  // corrector. This needs every ghost cell to come from the same level and
+  // no other sources than the MOL terms.
+  bool deep_halo = mol_deep_halo && (level == 0) && (!eb_in_domain);
+  for (int src : src_list) {
+    deep_halo = deep_halo && (src == diff_src);
   }
 
-  // U^* = U^n + dt*S^n
-  amrex::MultiFab::LinComb(S_new, 1.0, Sborder, 0, dt, molSrc, 0, 0, NVAR, 0);
+  amrex::Real reflux_factor = 0.5;
+  amrex::Vector<const amrex::MultiFab*> stage_srcs;
+  amrex::MultiFab S_deep;
+  amrex::MultiFab molSrc_deep;
+  if (deep_halo) {
+    const int ngb = nGrow_FP_border;
+    S_deep.define(grids, dmap, NVAR, 2 * ngb, amrex::MFInfo(), Factory());
+    molSrc_deep.define(grids, dmap, NVAR, ngb, amrex::MFInfo(), Factory());
+
+    // Lagged reaction source on the ghost cells, exchanged while the
+    // predictor source is computed
+    amrex::MultiFab I_R_deep;
+    if (do_react) {
+      I_R_deep.define(
+        grids, dmap, NUM_SPECIES + 1, ngb, amrex::MFInfo(), Factory());
+      I_R_deep.setVal(0.0);
+      amrex::MultiFab::Copy(I_R_deep, I_R, 0, 0, NUM_SPECIES + 1, 0);
+      I_R_deep.FillBoundary_nowait(geom.periodicity());
+    }
 
-  // U^{n+1,*} = U^n + dt*S^n + dt*I_R
-  if (do_react) {
-    amrex::MultiFab::Saxpy(S_new, dt, I_R, 0, FirstSpec, NUM_SPECIES, 0);
-    amrex::MultiFab::Saxpy(S_new, dt, I_R, NUM_SPECIES, Eden, 1, 0);
-  }
+    fill_stage_state(S_deep, 2 * ngb, time);
+    getMOLSrcTerm(
+      S_deep, molSrc_deep, time, dt, reflux_factor, MOLTerms::All, ngb);
 
-  computeTemp(S_new, 0);
+    if (do_react) {
+      I_R_deep.FillBoundary_finish();
+    }
+
+    // U^{n+1,*} = U^n + dt*S^n + dt*I_R on the valid and ghost cells, then
+    // the physical boundaries at t^{n+1}
+    const amrex::Vector<const amrex::MultiFab*> no_srcs;
+    mol_stage_update(
+      Sborder, 1.0, S_deep, 0.0, S_deep, dt, molSrc_deep, no_srcs, dt,
+      do_react ? I_R_deep : I_R, dt, false, true, ngb);
+    amrex::MultiFab::Copy(S_new, Sborder, 0, 0, NVAR, 0);
+    for (amrex::MFIter mfi(Sborder); mfi.isValid(); ++mfi) {
+      state[State_Type].FillBoundary(
+        Sborder[mfi], time + dt, geom.CellSize(), geom.ProbDomain(), 0, 0,
+        NVAR);
+    }
+
+    if (mol_iters > 1) {
+      amrex::MultiFab::Copy(molSrc_old, molSrc_deep, 0, 0, NVAR, 0);
+    }
+  } else {
+    fill_and_get_mol_src(
+      Sborder, molSrc, time, nGrow_FP_border, time, dt, reflux_factor);
+
+    // Build other (non-diffusion) sources at t_old
+    for (int src : src_list) {
+      if (src != diff_src) {
+        construct_old_source(src, time, dt, amr_iteration, amr_ncycle, 0, 0);
+        stage_srcs.push_back(old_sources[src].get());
+      }
+    }
+
+    // S^n += other sources
+    // U^{n+1,*} = U^n + dt*S^n + dt*I_R
+    mol_stage_update(
+      S_new, 1.0, Sborder, 0.0, S_old, dt, molSrc, stage_srcs, dt, I_R, dt,
+      false, true);
+
+    if (mol_iters > 1) {
+      amrex::MultiFab::Copy(molSrc_old, molSrc, 0, 0, NVAR, 0);
+    }
+  }
 
   // Compute S^{n+1} = MOLRhs(U^{n+1,*})
   if (verbose != 0) {
     amrex::Print() << "... Computing MOL source term at t^{n+1} " << std::endl;
   }
 
-  FillPatcherFill(Sborder, 0, NVAR, nGrow_FP_border, time + dt, State_Type, 0);
   reflux_factor = mol_iters > 1 ? 0 : 0.5;
-  getMOLSrcTerm(Sborder, molSrc, time, dt, reflux_factor);
+  if (deep_halo) {
+    getMOLSrcTerm(Sborder, molSrc, time, dt, reflux_factor);
+  } else {
+    fill_and_get_mol_src(
+      Sborder, molSrc, time + dt, nGrow_FP_border, time, dt, reflux_factor);
+  }
 
   // Build other (non-diffusion) sources at t_new
+  stage_srcs.clear();
   for (int src : src_list) {
     if (src != diff_src) {
       construct_new_source(src, time + dt, dt, amr_iteration, amr_ncycle, 0, 0);
-
-      // add sources to molsrc
-      amrex::MultiFab::Saxpy(molSrc, 1.0, *new_sources[src], 0, 0, NVAR, 0);
+      stage_srcs.push_back(new_sources[src].get());
     }
   }
 
+  // S^{n+1} += other sources
   // U^{n+1.**} = 0.5*(U^n + U^{n+1,*}) + 0.5*dt*S^{n+1} = U^n + 0.5*dt*S^n +
   // 0.5*dt*S^{n+1} + 0.5*dt*I_R
-  amrex::MultiFab::LinComb(S_new, 0.5, Sborder, 0, 0.5, S_old, 0, 0, NVAR, 0);
-  amrex::MultiFab::Saxpy(
-    S_new, 0.5 * dt, molSrc, 0, 0, NVAR,
-    0); //  NOTE: If I_R=0, we are done and U_new is the final new-time state
+  // NOTE: If I_R=0, we are done and U_new is the final new-time state
+  // Otherwise, F_{AD} = (1/dt)(U^{n+1,**} - U^n) - I_R = 0.5*(S^{n}+S^{n+1}
+  // (which is a guess!)) replaces S^{n+1} in molSrc
+  mol_stage_update(
+    S_new, 0.5, Sborder, 0.5, S_old, 0.5 * dt, molSrc, stage_srcs, 0.5 * dt,
+    I_R, dt, do_react, !do_react);
 
   if (do_react) {
-    amrex::MultiFab::Saxpy(S_new, 0.5 * dt, I_R, 0, FirstSpec, NUM_SPECIES, 0);
-    amrex::MultiFab::Saxpy(S_new, 0.5 * dt, I_R, NUM_SPECIES, Eden, 1, 0);
-
-    // F_{AD} = (1/dt)(U^{n+1,**} - U^n) - I_R = 0.5*(S^{n}+S^{n+1}(which is a
-    // guess!))
-    amrex::MultiFab::LinComb(
-      molSrc, 1.0 / dt, S_new, 0, -1.0 / dt, S_old, 0, 0, NVAR, 0);
-    amrex::MultiFab::Subtract(molSrc, I_R, 0, FirstSpec, NUM_SPECIES, 0);
-    amrex::MultiFab::Subtract(molSrc, I_R, NUM_SPECIES, Eden, 1, 0);
-
     // Compute I_R and U^{n+1} = U^n + dt*(F_{AD} + I_R)
     react_state(time, dt, false, &molSrc);
+
+    computeTemp(S_new, 0);
   }
 
-  computeTemp(S_new, 0);
+  if (do_react && (mol_iters > 1)) {
+    // Adaptive iterations reflux every iteration and drop the fluxes of the
+    // previous one, so they can stop at any iteration
+    const bool adaptive = mol_iters_tol > 0.0;
+    amrex::Vector<amrex::MultiFab> saved_flux;
+    amrex::MultiFab S_prev;
+    amrex::MultiFab IR_prev;
+    if (adaptive) {
+      save_flux_registers(saved_flux);
+      S_prev.define(grids, dmap, NVAR, 0, amrex::MFInfo(), Factory());
+      IR_prev.define(
+        grids, dmap, NUM_SPECIES + 1, 0, amrex::MFInfo(), Factory());
+    }
 
-  if (do_react) {
+    int iters_used = 1;
+    amrex::Real change = 0.0;
     for (int mol_iter = 2; mol_iter <= mol_iters; ++mol_iter) {
       if (verbose != 0) {
         amrex::Print() << "... Re-computing MOL source term at t^{n+1} (iter = "
                        << mol_iter << " of " << mol_iters << ")" << std::endl;
       }
 
-      FillPatcherFill(
-        Sborder, 0, NVAR, nGrow_FP_border, time + dt, State_Type, 0);
-      reflux_factor = mol_iter == mol_iters ? 0.5 : 0;
-      getMOLSrcTerm(Sborder, molSrc_new, time, dt, reflux_factor);
+      if (adaptive) {
+        if (mol_iter > 2) {
+          restore_flux_registers(saved_flux);
+        }
+        amrex::MultiFab::Copy(S_prev, S_new, 0, 0, NVAR, 0);
+        amrex::MultiFab::Copy(IR_prev, I_R, 0, 0, NUM_SPECIES + 1, 0);
+      }
+
+      reflux_factor = (adaptive || (mol_iter == mol_iters)) ? 0.5 : 0;
+      fill_and_get_mol_src(
+        Sborder, molSrc_new, time + dt, nGrow_FP_border, time, dt,
+        reflux_factor);
 
       // F_{AD} = (1/2)(molSrc_old + molSrc_new)
       amrex::MultiFab::LinComb(
@@ -187,6 +386,25 @@ PeleC::do_mol_advance(
       react_state(time, dt, false, &molSrc);
 
       computeTemp(S_new, 0);
+
+      iters_used = mol_iter;
+      if (adaptive) {
+        change = amrex::max(
+          iteration_change(S_prev, S_new, NVAR),
+          iteration_change(IR_prev, I_R, NUM_SPECIES + 1));
+        if (change < mol_iters_tol) {
+          break;
+        }
+      }
+    }
+
+    if (adaptive) {
+      amrex::Print() << "MOL iterations at level " << level << ": "
+                     << iters_used << " of " << mol_iters
+                     << " (relative change " << change << ")" << std::endl;
+      DtControl& ctrl = level_dt_control();
+      ctrl.iter_change = amrex::max(ctrl.iter_change, change);
+      ctrl.iters = amrex::max(ctrl.iters, iters_used);
     }
   }
 
@@ -195,9 +413,332 @@ PeleC::do_mol_advance(
   return dt;
 }
 
+void
+PeleC::do_mol_rk_advance(
+  amrex::Real time,
+  amrex::Real dt,
+  int amr_iteration,
+  int amr_ncycle,
+  amrex::MultiFab& molSrc,
+  int nGrow_FP_border)
+{
+  // Advance with the low storage RK scheme mol_rk (see MOLRK.H). The stage
+  // state is S_new, Sborder its ghosted copy and R the auxiliary register.
+  // The reaction source I_R of the previous step is lagged in every stage,
+  // as in the predictor-corrector. With diffusion_sts, the RK stages only
+  // hold the hyperbolic terms and the diffusion is Strang split around them.
+  BL_PROFILE("PeleC::do_mol_rk_advance()");
+
+  amrex::MultiFab& S_old = get_old_data(State_Type);
+  amrex::MultiFab& S_new = get_new_data(State_Type);
+  const amrex::MultiFab& I_R = get_new_data(Reactions_Type);
+
+  amrex::MultiFab R;
+  if (mol_rk.uses_register) {
+    R.define(grids, dmap, NVAR, 0, amrex::MFInfo(), Factory());
+  }
+
+  const bool sts = diffusion_sts && do_diffuse;
+  const int terms = sts ? MOLTerms::Hydro : MOLTerms::All;
+  amrex::MultiFab U0_split;
+  if (sts) {
+    diffusion_sts_advance(time, dt, 0.5 * dt, false, nGrow_FP_border);
+    U0_split.define(grids, dmap, NVAR, 0, amrex::MFInfo(), Factory());
+    amrex::MultiFab::Copy(U0_split, S_new, 0, 0, NVAR, 0);
+  }
+  const amrex::MultiFab& U0 = sts ? U0_split : S_old;
+
+  const int nstages = static_cast<int>(mol_rk.stages.size());
+  const amrex::Vector<const amrex::MultiFab*> no_srcs;
+  amrex::Vector<const amrex::MultiFab*> stage_srcs;
+  for (int ks = 0; ks < nstages; ++ks) {
+    const MOLRKStage& st = mol_rk.stages[ks];
+    const amrex::Real stage_time = time + mol_rk.times[ks] * dt;
+    if (verbose != 0) {
+      amrex::Print() << "... Computing MOL source term of " << mol_rk.name
+                     << " stage " << ks + 1 << " of " << nstages << std::endl;
+    }
+
+    // The stages after the first (or all of them after a diffusion half
+    // step) start from S_new, whose valid data is at the end of the step for
+    // the fill
+    fill_and_get_mol_src(
+      Sborder, molSrc, ((ks == 0) && (!sts)) ? time : time + dt,
+      nGrow_FP_border, time, dt, mol_rk.weights[ks], terms);
+
+    // Other (non-diffusion) sources at the stage time
+    stage_srcs.clear();
+    for (int src : src_list) {
+      if (src != diff_src) {
+        if (ks == 0) {
+          construct_old_source(src, time, dt, amr_iteration, amr_ncycle, 0, 0);
+          stage_srcs.push_back(old_sources[src].get());
+        } else {
+          construct_new_source(
+            src, stage_time, dt, amr_iteration, amr_ncycle, 0, 0);
+          stage_srcs.push_back(new_sources[src].get());
+        }
+      }
+    }
+
+    if (mol_rk.williamson) {
+      // R = a*R + dt*(L + I_R), then U = U + b*R
+      mol_stage_update(
+        R, st.a, st.a != 0.0 ? R : Sborder, 0.0, Sborder, dt, molSrc,
+        stage_srcs, dt, I_R, dt, false, false);
+      mol_stage_update(
+        S_new, 1.0, Sborder, st.b, R, 0.0, molSrc, no_srcs, 0.0, I_R, dt,
+        false, true);
+    } else {
+      // U = a*U^n + b*U + c*dt*(L + I_R) + e*R
+      AMREX_ASSERT((st.a == 0.0) || (st.e == 0.0));
+      mol_stage_update(
+        S_new, st.e != 0.0 ? st.e : st.a, st.e != 0.0 ? R : U0, st.b,
+        Sborder, st.c * dt, molSrc, stage_srcs, st.c * dt, I_R, dt, false,
+        true);
+
+      // R = r*R + ru*U_k + rl*dt*(L(U_k) + I_R) + rn*U
+      if (st.updates_register()) {
+        if (st.r == 0.0) {
+          R.setVal(0.0);
+        } else if (st.r != 1.0) {
+          R.mult(st.r, 0, NVAR, 0);
+        }
+        if (st.ru != 0.0) {
+          amrex::MultiFab::Saxpy(R, st.ru, Sborder, 0, 0, NVAR, 0);
+        }
+        if (st.rl != 0.0) {
+          amrex::MultiFab::Saxpy(R, st.rl * dt, molSrc, 0, 0, NVAR, 0);
+          if (do_react) {
+            amrex::MultiFab::Saxpy(R, st.rl * dt, I_R, 0, UFS, NUM_SPECIES, 0);
+            amrex::MultiFab::Saxpy(
+              R, st.rl * dt, I_R, NUM_SPECIES, UEDEN, 1, 0);
+          }
+        }
+        if (st.rn != 0.0) {
+          amrex::MultiFab::Saxpy(R, st.rn, S_new, 0, 0, NVAR, 0);
+        }
+      }
+    }
+  }
+
+  if (sts) {
+    diffusion_sts_advance(time, dt, 0.5 * dt, true, nGrow_FP_border);
+  }
+
+  if (do_react) {
+    // F_{AD} = (1/dt)(U^{n+1} - U^n) - I_R, then I_R and
+    // U^{n+1} = U^n + dt*(F_{AD} + I_R)
+    mol_stage_update(
+      S_new, 1.0, S_new, 0.0, S_old, 0.0, molSrc, no_srcs, 0.0, I_R, dt, true,
+      false);
+    react_state(time, dt, false, &molSrc);
+
+    computeTemp(S_new, 0);
+  }
+}
+
+void
+PeleC::diffusion_sts_advance(
+  amrex::Real time,
+  amrex::Real dt,
+  amrex::Real dtau,
+  bool from_new,
+  int nGrow_FP_border)
+{
+  // RKL2 super-time-stepping of the diffusion terms over dtau, from S_old
+  // (or S_new if from_new) into S_new. Y_{j-1} is S_new (and the valid data
+  // of Sborder), updated in place into Y_j, and Y_{j-2} is held in Ym2.
+  BL_PROFILE("PeleC::diffusion_sts_advance()");
+
+  amrex::MultiFab& S_old = get_old_data(State_Type);
+  amrex::MultiFab& S_new = get_new_data(State_Type);
+
+  // Forward Euler diffusion limit of the input state
+  amrex::Real dts[4];
+  estTimeStepLimits(from_new ? S_new : S_old, dts);
+  const amrex::Real dt_fe = cfl * amrex::min(dts[1], dts[2], dts[3]);
+  const int nstages = rkl2_stages(dtau, dt_fe);
+  const RKL2Scheme rkl = make_rkl2_scheme(nstages);
+  if (verbose != 0) {
+    amrex::Print() << "... Diffusion super-time-step of " << dtau << " with "
+                   << nstages << " RKL2 stages" << std::endl;
+    if (nstages > diffusion_sts_max_stages) {
+      amrex::Print() << "WARNING -- more than diffusion_sts_max_stages stages"
+                     << std::endl;
+    }
+  }
+
+  amrex::MultiFab Y0(grids, dmap, NVAR, 0, amrex::MFInfo(), Factory());
+  amrex::MultiFab Ym2(grids, dmap, NVAR, 0, amrex::MFInfo(), Factory());
+  amrex::MultiFab LY0(grids, dmap, NVAR, 0, amrex::MFInfo(), Factory());
+  amrex::MultiFab L(grids, dmap, NVAR, 0, amrex::MFInfo(), Factory());
+
+  // Each stage update is a single pass over the valid cells
+  auto const& snew = S_new.arrays();
+  auto const& y0 = Y0.arrays();
+  auto const& ym2 = Ym2.arrays();
+  auto const& ly0 = LY0.const_arrays();
+  auto const& l = L.const_arrays();
+
+  // Y_1 = Y_0 + mut_1*dtau*L(Y_0)
+  fill_stage_state(Sborder, nGrow_FP_border, from_new ? time + dt : time);
+  getMOLSrcTerm(
+    Sborder, LY0, time, dt, rkl.weights[0] * dtau / dt, MOLTerms::Diffusion);
+  {
+    auto const& from = (from_new ? S_new : S_old).const_arrays();
+    const amrex::Real c1 = rkl.mut[1] * dtau;
+    amrex::ParallelFor(
+      S_new, amrex::IntVect(0), NVAR,
+      [=] AMREX_GPU_DEVICE(int nbx, int i, int j, int k, int n) noexcept {
+        const amrex::Real u0 = from[nbx](i, j, k, n);
+        y0[nbx](i, j, k, n) = u0;
+        ym2[nbx](i, j, k, n) = u0;
+        snew[nbx](i, j, k, n) = u0 + c1 * ly0[nbx](i, j, k, n);
+      });
+  }
+  computeTemp(S_new, 0);
+
+  for (int js = 2; js <= nstages; ++js) {
+    fill_stage_state(Sborder, nGrow_FP_border, time + dt);
+    getMOLSrcTerm(
+      Sborder, L, time, dt, rkl.weights[js - 1] * dtau / dt,
+      MOLTerms::Diffusion);
+
+    // Y_j = mu_j*Y_{j-1} + nu_j*Y_{j-2} + (1 - mu_j - nu_j)*Y_0
+    //       + mut_j*dtau*L(Y_{j-1}) + gt_j*dtau*L(Y_0)
+    const amrex::Real mu = rkl.mu[js];
+    const amrex::Real nu = rkl.nu[js];
+    const amrex::Real c0 = 1.0 - mu - nu;
+    const amrex::Real cl = rkl.mut[js] * dtau;
+    const amrex::Real cl0 = rkl.gt[js] * dtau;
+    amrex::ParallelFor(
+      S_new, amrex::IntVect(0), NVAR,
+      [=] AMREX_GPU_DEVICE(int nbx, int i, int j, int k, int n) noexcept {
+        const amrex::Real ujm1 = snew[nbx](i, j, k, n);
+        snew[nbx](i, j, k, n) =
+          mu * ujm1 + nu * ym2[nbx](i, j, k, n) + c0 * y0[nbx](i, j, k, n) +
+          cl * l[nbx](i, j, k, n) + cl0 * ly0[nbx](i, j, k, n);
+        ym2[nbx](i, j, k, n) = ujm1;
+      });
+    computeTemp(S_new, 0);
+  }
+  clear_prim_cache();
+}
+
+void
+PeleC::mol_stage_update(
+  amrex::MultiFab& S,
+  amrex::Real a,
+  const amrex::MultiFab& A,
+  amrex::Real b,
+  const amrex::MultiFab& B,
+  amrex::Real c,
+  amrex::MultiFab& src,
+  const amrex::Vector<const amrex::MultiFab*>& add_srcs,
+  amrex::Real d,
+  const amrex::MultiFab& I_R,
+  amrex::Real dt,
+  bool compute_fad,
+  bool compute_temp,
+  int ng)
+{
+  // One pass over the valid cells of each box for a whole MOL stage:
+  //   src += sum of add_srcs
+  //   S = a*A + b*B + c*src + d*I_R (I_R only with reactions)
+  //   src = (S - B)/dt - I_R (compute_fad)
+  //   then the internal energy reset and the temperature (compute_temp)
+  // on ng ghost cells too, when the inputs have them
+  BL_PROFILE("PeleC::mol_stage_update()");
+
+  clear_prim_cache();
+
+  const int nsrc = static_cast<int>(add_srcs.size());
+  AMREX_ALWAYS_ASSERT(nsrc <= num_src);
+
+  // The energy diagnostics of reset_internal_energy need the state before
+  // the reset
+  bool fuse_temp = compute_temp;
+#ifndef AMREX_USE_GPU
+  if ((parent->finestLevel() == 0) && print_energy_diagnostics) {
+    fuse_temp = false;
+  }
+#endif
+
+  const bool use_ir = do_react;
+  const auto captured_allow_small_energy = allow_small_energy;
+  const auto captured_allow_negative_energy = allow_negative_energy;
+  const auto captured_dual_energy_update_E_from_e =
+    dual_energy_update_E_from_e;
+  const auto captured_verbose = verbose;
+  const auto captured_dual_energy_eta2 = dual_energy_eta2;
+
+  auto const& fact =
+    dynamic_cast<amrex::EBFArrayBoxFactory const&>(S.Factory());
+  auto const& flags = fact.getMultiEBCellFlagFab();
+
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
+#endif
+  for (amrex::MFIter mfi(S, amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi) {
+    const amrex::Box bx = mfi.growntilebox(ng);
+    auto const& s = S.array(mfi);
+    auto const& sa = A.const_array(mfi);
+    auto const& sb = B.const_array(mfi);
+    auto const& f = src.array(mfi);
+    auto const& ir = I_R.const_array(mfi);
+    auto const& flag = flags.const_array(mfi);
+    amrex::GpuArray<amrex::Array4<const amrex::Real>, num_src> srcs;
+    for (int m = 0; m < nsrc; m++) {
+      srcs[m] = add_srcs[m]->const_array(mfi);
+    }
+
+    amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
+      for (int n = 0; n < NVAR; n++) {
+        amrex::Real fn = f(i, j, k, n);
+        for (int m = 0; m < nsrc; m++) {
+          fn += srcs[m](i, j, k, n);
+        }
+
+        amrex::Real r = 0.0;
+        if (use_ir) {
+          if ((n >= UFS) && (n < UFS + NUM_SPECIES)) {
+            r = ir(i, j, k, n - UFS);
+          } else if (n == UEDEN) {
+            r = ir(i, j, k, NUM_SPECIES);
+          }
+        }
+
+        const amrex::Real u =
+          a * sa(i, j, k, n) + b * sb(i, j, k, n) + c * fn + d * r;
+        s(i, j, k, n) = u;
+        f(i, j, k, n) = compute_fad ? (u - sb(i, j, k, n)) / dt - r : fn;
+      }
+
+      if (fuse_temp) {
+        pc_rst_int_e(
+          i, j, k, s, captured_allow_small_energy,
+          captured_allow_negative_energy, captured_dual_energy_update_E_from_e,
+          captured_dual_energy_eta2, captured_verbose);
+        if (!flag(i, j, k).isCovered()) {
+          pc_cmpTemp(i, j, k, s);
+        }
+      }
+    });
+  }
+
+  if (compute_temp && !fuse_temp) {
+    computeTemp(S, ng);
+  }
+}
+
 amrex::Real
 PeleC::do_sdc_advance(
-  amrex::Real time, amrex::Real dt, int amr_iteration, int amr_ncycle)
+  amrex::Real time,
+  amrex::Real dt,
+  int amr_iteration,
+  int amr_ncycle,
+  int nsweeps)
 {
   BL_PROFILE("PeleC::do_sdc_advance()");
 
@@ -214,14 +755,68 @@ PeleC::do_sdc_advance(
     get_new_data(Work_Estimate_Type).setVal(0.0);
   }
 
-  for (int sdc_iter = 0; sdc_iter < sdc_iters; ++sdc_iter) {
-    if (sdc_iters > 1) {
-      amrex::Print() << "SDC iteration " << sdc_iter + 1 << " of " << sdc_iters
+  // Adaptive iterations: the first iteration never refluxes, each later one
+  // is handed as the last (so it refluxes) after dropping the fluxes of the
+  // previous one, and the loop stops once the iterate stops changing
+  const bool adaptive = (sdc_iters_tol > 0.0) && (nsweeps > 1);
+  amrex::Vector<amrex::MultiFab> saved_flux;
+  amrex::MultiFab S_prev;
+  amrex::MultiFab IR_prev;
+  if (adaptive) {
+    S_prev.define(grids, dmap, NVAR, 0, amrex::MFInfo(), Factory());
+    if (do_react) {
+      IR_prev.define(
+        grids, dmap, NUM_SPECIES + 1, 0, amrex::MFInfo(), Factory());
+    }
+  }
+
+  int iters_used = 0;
+  amrex::Real change = 0.0;
+  for (int sdc_iter = 0; sdc_iter < nsweeps; ++sdc_iter) {
+    if (nsweeps > 1) {
+      amrex::Print() << "SDC iteration " << sdc_iter + 1 << " of " << nsweeps
                      << ".\n";
     }
 
+    if (adaptive && (sdc_iter > 0)) {
+      if (sdc_iter == 1) {
+        save_flux_registers(saved_flux);
+      } else {
+        restore_flux_registers(saved_flux);
+      }
+      amrex::MultiFab::Copy(S_prev, get_new_data(State_Type), 0, 0, NVAR, 0);
+      if (do_react) {
+        amrex::MultiFab::Copy(
+          IR_prev, get_new_data(Reactions_Type), 0, 0, NUM_SPECIES + 1, 0);
+      }
+    }
+
+    const int sub_ncycle =
+      (adaptive && (sdc_iter > 0)) ? sdc_iter + 1 : nsweeps;
     dt_new = do_sdc_iteration(
-      time, dt, amr_iteration, amr_ncycle, sdc_iter, sdc_iters);
+      time, dt, amr_iteration, amr_ncycle, sdc_iter, sub_ncycle);
+
+    iters_used = sdc_iter + 1;
+    if (adaptive && (sdc_iter > 0)) {
+      change = iteration_change(S_prev, get_new_data(State_Type), NVAR);
+      if (do_react) {
+        change = amrex::max(
+          change, iteration_change(
+                    IR_prev, get_new_data(Reactions_Type), NUM_SPECIES + 1));
+      }
+      if (change < sdc_iters_tol) {
+        break;
+      }
+    }
+  }
+
+  if (adaptive) {
+    amrex::Print() << "SDC iterations at level " << level << ": "
+                   << iters_used << " of " << nsweeps << " (relative change "
+                   << change << ")" << std::endl;
+    DtControl& ctrl = level_dt_control();
+    ctrl.iter_change = amrex::max(ctrl.iter_change, change);
+    ctrl.iters = amrex::max(ctrl.iters, iters_used);
   }
 
   finalize_sdc_advance(time, dt, amr_iteration, amr_ncycle);
@@ -272,7 +867,7 @@ PeleC::do_sdc_iteration(
 #endif
 
   if (fill_Sborder) {
-    FillPatcherFill(Sborder, 0, NVAR, nGrow_FP_border, time, State_Type, 0);
+    fill_stage_state(Sborder, nGrow_FP_border, time);
   }
 
   if (sub_iteration == 0) {
@@ -325,7 +920,7 @@ PeleC::do_sdc_iteration(
     if (do_spray_particles && level > 0) {
       nGrowDiff = amrex::max(nGrowDiff, nGrow_FP_border);
     }
-    FillPatcherFill(Sborder, 0, NVAR, nGrowDiff, time + dt, State_Type, 0);
+    fill_stage_state(Sborder, nGrowDiff, time + dt);
   }
   if (do_diffuse) {
     if (verbose != 0) {
@@ -353,6 +948,7 @@ PeleC::do_sdc_iteration(
   }
 
   computeTemp(S_new, ng_src);
+  clear_prim_cache();
 
   finalize_sdc_iteration(
     time, dt, amr_iteration, amr_ncycle, sub_iteration, sub_ncycle);
@@ -366,6 +962,7 @@ PeleC::construct_Snew(
 {
   int ng = 0;
 
+  clear_prim_cache();
   amrex::MultiFab::Copy(S_new, S_old, 0, 0, NVAR, ng);
   for (int src : src_list) {
     amrex::MultiFab::Saxpy(S_new, 0.5 * dt, *new_sources[src], 0, 0, NVAR, ng);
@@ -382,6 +979,68 @@ PeleC::construct_Snew(
   }
 }
 
+amrex::Real
+PeleC::iteration_change(
+  amrex::MultiFab& prev, const amrex::MultiFab& cur, int ncomp)
+{
+  // Largest change of a component from prev to cur relative to its max norm
+  // in cur, with a single collective. prev is overwritten.
+  amrex::MultiFab::Subtract(prev, cur, 0, 0, ncomp, 0);
+  amrex::Vector<int> comps(ncomp);
+  for (int n = 0; n < ncomp; n++) {
+    comps[n] = n;
+  }
+  amrex::Vector<amrex::Real> norms = prev.norm0(comps, 0, true, true);
+  const amrex::Vector<amrex::Real> refs = cur.norm0(comps, 0, true, true);
+  norms.insert(norms.end(), refs.begin(), refs.end());
+  amrex::ParallelDescriptor::ReduceRealMax(norms.data(), 2 * ncomp);
+
+  amrex::Real change = 0.0;
+  for (int n = 0; n < ncomp; n++) {
+    if (norms[ncomp + n] > 0.0) {
+      change = amrex::max(change, norms[n] / norms[ncomp + n]);
+    }
+  }
+  return change;
+}
+
+void
+PeleC::save_flux_registers(amrex::Vector<amrex::MultiFab>& saved)
+{
+  // The coarse data of the register above this level and the fine data of
+  // the register at this level are the only ones an iteration adds to
+  saved.clear();
+  saved.resize(2);
+  if (!do_reflux) {
+    return;
+  }
+  if (level < parent->finestLevel()) {
+    const amrex::MultiFab& crse = getFluxReg(level + 1).getCrseData();
+    saved[0].define(
+      crse.boxArray(), crse.DistributionMap(), crse.nComp(), crse.nGrow());
+    amrex::MultiFab::Copy(saved[0], crse, 0, 0, crse.nComp(), crse.nGrow());
+  }
+  if (level > 0) {
+    const amrex::MultiFab& fine = getFluxReg(level).getFineData();
+    saved[1].define(
+      fine.boxArray(), fine.DistributionMap(), fine.nComp(), fine.nGrow());
+    amrex::MultiFab::Copy(saved[1], fine, 0, 0, fine.nComp(), fine.nGrow());
+  }
+}
+
+void
+PeleC::restore_flux_registers(const amrex::Vector<amrex::MultiFab>& saved)
+{
+  if (saved[0].isDefined()) {
+    amrex::MultiFab& crse = getFluxReg(level + 1).getCrseData();
+    amrex::MultiFab::Copy(crse, saved[0], 0, 0, crse.nComp(), crse.nGrow());
+  }
+  if (saved[1].isDefined()) {
+    amrex::MultiFab& fine = getFluxReg(level).getFineData();
+    amrex::MultiFab::Copy(fine, saved[1], 0, 0, fine.nComp(), fine.nGrow());
+  }
+}
+
 void
 PeleC::initialize_sdc_iteration(
   amrex::Real /*time*/,
@@ -0,0 +1,286 @@
+#include "PelePhysics.H"
+#include "ChemCache.H"
+
+namespace {
+// Largest extent of an EOA in scaled coordinates, bounding the region of
+// trust in directions the mapping is insensitive to
+constexpr amrex::Real eoa_max_radius = 0.1;
+} // namespace
+
+ChemCache::ChemCache(amrex::Real tolerance, amrex::Real max_mb)
+  : m_tol(tolerance)
+{
+  const double record_bytes =
+    sizeof(Record) + 2 * sizeof(Node) +
+    static_cast<double>(NY * NX + NX * NX) * sizeof(amrex::Real);
+  m_max_records =
+    amrex::max<int>(1, static_cast<int>(max_mb * 1024 * 1024 / record_bytes));
+}
+
+void
+ChemCache::scales(
+  const amrex::Real* x, amrex::Real T, amrex::Real* xs, amrex::Real* ys)
+{
+  amrex::Real rho = 0.0;
+  for (int n = 0; n < NUM_SPECIES; n++) {
+    rho += x[n];
+  }
+  amrex::Real Y[NUM_SPECIES] = {0.0};
+  for (int n = 0; n < NUM_SPECIES; n++) {
+    Y[n] = x[n] / rho;
+  }
+  amrex::Real cv = 0.0;
+  auto eos = pele::physics::PhysicsType::eos();
+  eos.RTY2Cv(rho, T, Y, cv);
+
+  const amrex::Real escale = rho * cv * T;
+  const amrex::Real dt = x[NX - 1];
+  for (int n = 0; n < NUM_SPECIES; n++) {
+    xs[n] = rho;
+    xs[NUM_SPECIES + 1 + n] = rho / dt;
+    ys[n] = rho;
+  }
+  xs[NUM_SPECIES] = escale;
+  xs[2 * NUM_SPECIES + 1] = escale / dt;
+  xs[2 * NUM_SPECIES + 2] = dt;
+  ys[NUM_SPECIES] = T;
+  ys[NUM_SPECIES + 1] = escale;
+}
+
+int
+ChemCache::find_leaf(const amrex::Real* x) const
+{
+  int node = m_root;
+  while (m_nodes[node].record < 0) {
+    const Node& nd = m_nodes[node];
+    amrex::Real vx = 0.0;
+    for (int c = 0; c < NX; c++) {
+      vx += nd.v[c] * x[c];
+    }
+    node = (vx > nd.a) ? nd.right : nd.left;
+  }
+  return node;
+}
+
+int
+ChemCache::new_node()
+{
+  int node = 0;
+  if (m_free_nodes.empty()) {
+    node = static_cast<int>(m_nodes.size());
+    m_nodes.emplace_back();
+  } else {
+    node = m_free_nodes.back();
+    m_free_nodes.pop_back();
+    m_nodes[node] = Node();
+  }
+  return node;
+}
+
+bool
+ChemCache::retrieve(const amrex::Real* x, amrex::Real* y, int& rid)
+{
+  m_counters.query++;
+  rid = -1;
+  if (m_root < 0) {
+    return false;
+  }
+
+  rid = m_nodes[find_leaf(x)].record;
+  Record& r = m_records[rid];
+
+  amrex::Real d[NX];
+  for (int c = 0; c < NX; c++) {
+    d[c] = (x[c] - r.x[c]) / r.xs[c];
+  }
+  amrex::Real s = 0.0;
+  for (int i = 0; i < NX; i++) {
+    amrex::Real Md = 0.0;
+    for (int j = 0; j < NX; j++) {
+      Md += r.M[i * NX + j] * d[j];
+    }
+    s += d[i] * Md;
+  }
+  if (s > 1.0) {
+    return false;
+  }
+
+  for (int i = 0; i < NY; i++) {
+    y[i] = r.y[i];
+    for (int c = 0; c < NX; c++) {
+      y[i] += r.A[i * NX + c] * (x[c] - r.x[c]);
+    }
+  }
+  m_lru.splice(m_lru.begin(), m_lru, r.lru);
+  m_counters.hit++;
+  return true;
+}
+
+bool
+ChemCache::grow(int rid, const amrex::Real* x, const amrex::Real* y)
+{
+  Record& r = m_records[rid];
+
+  // Error of the linear approximation at x
+  amrex::Real err2 = 0.0;
+  for (int i = 0; i < NY; i++) {
+    amrex::Real yl = r.y[i];
+    for (int c = 0; c < NX; c++) {
+      yl += r.A[i * NX + c] * (x[c] - r.x[c]);
+    }
+    const amrex::Real e = (y[i] - yl) / r.ys[i];
+    err2 += e * e;
+  }
+  if (err2 > m_tol * m_tol) {
+    return false;
+  }
+
+  // Smallest update of the EOA (same center) that contains x:
+  // M <- M - (s - 1) / s^2 (M d)(M d)^T, with s = d^T M d
+  amrex::Real d[NX];
+  amrex::Real Md[NX];
+  for (int c = 0; c < NX; c++) {
+    d[c] = (x[c] - r.x[c]) / r.xs[c];
+  }
+  amrex::Real s = 0.0;
+  for (int i = 0; i < NX; i++) {
+    Md[i] = 0.0;
+    for (int j = 0; j < NX; j++) {
+      Md[i] += r.M[i * NX + j] * d[j];
+    }
+    s += d[i] * Md[i];
+  }
+  if (s > 1.0) {
+    const amrex::Real f = (s - 1.0) / (s * s);
+    for (int i = 0; i < NX; i++) {
+      for (int j = 0; j < NX; j++) {
+        r.M[i * NX + j] -= f * Md[i] * Md[j];
+      }
+    }
+  }
+
+  m_lru.splice(m_lru.begin(), m_lru, r.lru);
+  m_counters.grow++;
+  return true;
+}
+
+void
+ChemCache::add(
+  const amrex::Real* x, const amrex::Real* y, const amrex::Real* A)
+{
+  if (m_nrecords >= m_max_records) {
+    evict();
+  }
+
+  int rid = 0;
+  if (m_free_records.empty()) {
+    rid = static_cast<int>(m_records.size());
+    m_records.emplace_back();
+  } else {
+    rid = m_free_records.back();
+    m_free_records.pop_back();
+  }
+  Record& r = m_records[rid];
+
+  for (int c = 0; c < NX; c++) {
+    r.x[c] = x[c];
+  }
+  for (int i = 0; i < NY; i++) {
+    r.y[i] = y[i];
+  }
+  scales(x, y[NUM_SPECIES], r.xs, r.ys);
+  r.A.assign(A, A + NY * NX);
+
+  // Initial EOA: region where the scaled linear correction stays within the
+  // tolerance, M = As^T As / tol^2 + I / r^2 with As = Ys^-1 A Xs
+  r.M.assign(NX * NX, 0.0);
+  const amrex::Real itol2 = 1.0 / (m_tol * m_tol);
+  for (int i = 0; i < NX; i++) {
+    for (int j = i; j < NX; j++) {
+      amrex::Real m = 0.0;
+      for (int k = 0; k < NY; k++) {
+        m += (A[k * NX + i] * r.xs[i] / r.ys[k]) *
+             (A[k * NX + j] * r.xs[j] / r.ys[k]);
+      }
+      m *= itol2;
+      if (i == j) {
+        m += 1.0 / (eoa_max_radius * eoa_max_radius);
+      }
+      r.M[i * NX + j] = m;
+      r.M[j * NX + i] = m;
+    }
+  }
+
+  // Insert in the tree, splitting the closest leaf with the plane that
+  // bisects the two records in scaled coordinates
+  const int leaf = new_node();
+  m_nodes[leaf].record = rid;
+  r.node = leaf;
+  if (m_root < 0) {
+    m_root = leaf;
+  } else {
+    const int old = find_leaf(x);
+    const Record& ro = m_records[m_nodes[old].record];
+    const int parent = new_node();
+    Node& p = m_nodes[parent];
+    p.a = 0.0;
+    for (int c = 0; c < NX; c++) {
+      p.v[c] = (x[c] - ro.x[c]) / (r.xs[c] * r.xs[c]);
+      p.a += 0.5 * p.v[c] * (x[c] + ro.x[c]);
+    }
+    const int gp = m_nodes[old].parent;
+    p.parent = gp;
+    p.left = old;
+    p.right = leaf;
+    if (gp < 0) {
+      m_root = parent;
+    } else if (m_nodes[gp].left == old) {
+      m_nodes[gp].left = parent;
+    } else {
+      m_nodes[gp].right = parent;
+    }
+    m_nodes[old].parent = parent;
+    m_nodes[leaf].parent = parent;
+  }
+
+  m_lru.push_front(rid);
+  r.lru = m_lru.begin();
+  m_nrecords++;
+  m_counters.add++;
+}
+
+void
+ChemCache::evict()
+{
+  const int rid = m_lru.back();
+  m_lru.pop_back();
+  Record& r = m_records[rid];
+
+  // Replace the parent of the leaf by its sibling
+  const int leaf = r.node;
+  const int parent = m_nodes[leaf].parent;
+  if (parent < 0) {
+    m_root = -1;
+  } else {
+    const int sib = (m_nodes[parent].left == leaf) ? m_nodes[parent].right
+                                                   : m_nodes[parent].left;
+    const int gp = m_nodes[parent].parent;
+    m_nodes[sib].parent = gp;
+    if (gp < 0) {
+      m_root = sib;
+    } else if (m_nodes[gp].left == parent) {
+      m_nodes[gp].left = sib;
+    } else {
+      m_nodes[gp].right = sib;
+    }
+    m_free_nodes.push_back(parent);
+  }
+  m_free_nodes.push_back(leaf);
+
+  r.A.clear();
+  r.M.clear();
+  r.node = -1;
+  m_free_records.push_back(rid);
+  m_nrecords--;
+  m_counters.evict++;
+}
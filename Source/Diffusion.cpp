@@ -7,12 +7,16 @@ PeleC::getMOLSrcTerm(
   amrex::MultiFab& MOLSrcTerm,
   const amrex::Real /*time*/,
   const amrex::Real dt,
-  const amrex::Real reflux_factor)
+  const amrex::Real reflux_factor,
+  const int terms,
+  const int ng_src,
+  const int region,
+  amrex::Array<amrex::MultiFab, AMREX_SPACEDIM>* flux_store)
 {
   BL_PROFILE("PeleC::getMOLSrcTerm()");
-  if (
-    (!diffuse_temp) && (!diffuse_enth) && (!diffuse_spec) && (!diffuse_vel) &&
-    (!do_hydro)) {
+  const bool add_diffusion = do_diffuse && (terms != MOLTerms::Hydro);
+  const bool add_hydro = do_hydro && (terms != MOLTerms::Diffusion);
+  if ((!add_diffusion) && (!add_hydro)) {
     MOLSrcTerm.setVal(0, 0, NVAR, MOLSrcTerm.nGrow());
     return;
   }
@@ -42,6 +46,16 @@ PeleC::getMOLSrcTerm(
 
      6. Perform weighted redistribution at the EB
 
+     With ng_src > 0, the rhs is also computed on ng_src ghost cells of
+     MOLSrcTerm, from the same data as the neighbouring boxes (mol_deep_halo),
+     rather than extrapolated. Only the valid fluxes are refluxed.
+
+     With region, only that part of each tile is computed (see MOLRegion).
+     With flux_store, the face fluxes of the computed cells are stored there
+     rather than added to the flux registers.
+
+     With prim_cache, steps 1 and 2 read the cache of this fill of S.
+
      Extra notes:
 
      A. The face-based transport coefficients that are computed with face-based
@@ -72,13 +86,26 @@ PeleC::getMOLSrcTerm(
     cost = &(get_new_data(Work_Estimate_Type));
   }
 
+  // The cache covers gbox of every tile when it holds S on numGrow() +
+  // ng_src ghost cells
+  const bool use_cache = prim_cached(S, numGrow() + ng_src) &&
+                         (prim_cache_coeff || (!add_diffusion));
+
 #ifdef AMREX_USE_OMP
 #pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
 #endif
   {
     for (amrex::MFIter mfi(MOLSrcTerm, amrex::TilingIfNotGPU()); mfi.isValid();
          ++mfi) {
-      const amrex::Box vbox = mfi.tilebox();
+      const amrex::Box vbox =
+        (region == MOLRegion::All)
+          ? mfi.growntilebox(ng_src)
+          : mol_region_box(mfi.tilebox(), mfi.validbox(), numGrow(), region);
+      if (!vbox.ok()) {
+        continue;
+      }
+      // Cells of the tile computed here, for the work estimate
+      const amrex::Box tbox = mfi.tilebox() & vbox;
       int ng = numGrow();
       const amrex::Box gbox = amrex::grow(vbox, ng);
       const amrex::Box cbox = amrex::grow(vbox, ng - 1);
@@ -90,8 +117,8 @@ PeleC::getMOLSrcTerm(
       if (typ == amrex::FabType::covered) {
         setV(vbox, NVAR, MOLSrc, 0);
         if (do_mol_load_balance && (cost != nullptr)) {
-          wt = (amrex::ParallelDescriptor::second() - wt) / vbox.d_numPts();
-          (*cost)[mfi].plus<amrex::RunOn::Device>(wt, vbox);
+          wt = (amrex::ParallelDescriptor::second() - wt) / tbox.d_numPts();
+          (*cost)[mfi].plus<amrex::RunOn::Device>(wt, tbox);
         }
         continue;
       }
@@ -114,16 +141,31 @@ PeleC::getMOLSrcTerm(
       auto* d_sv_eb_bndry_geom =
         (Ncut > 0 ? sv_eb_bndry_geom[local_i].data() : nullptr);
 
+      // Primitives and transport coefficients of this fill of S from the
+      // cache (prim_cache), computed here otherwise
       const int nqaux = NQAUX > 0 ? NQAUX : 1;
-      amrex::FArrayBox q(gbox, QVAR, amrex::The_Async_Arena());
-      amrex::FArrayBox qaux(gbox, nqaux, amrex::The_Async_Arena());
-      amrex::FArrayBox coeff_cc(gbox, nCompTr, amrex::The_Async_Arena());
+      amrex::FArrayBox q;
+      amrex::FArrayBox qaux;
+      amrex::FArrayBox coeff_cc;
+      if (use_cache) {
+        q = amrex::FArrayBox(prim_q[mfi], amrex::make_alias, 0, QVAR);
+        qaux = amrex::FArrayBox(prim_qaux[mfi], amrex::make_alias, 0, nqaux);
+      } else {
+        q.resize(gbox, QVAR, amrex::The_Async_Arena());
+        qaux.resize(gbox, nqaux, amrex::The_Async_Arena());
+      }
+      if (use_cache && add_diffusion) {
+        coeff_cc =
+          amrex::FArrayBox(prim_coeff[mfi], amrex::make_alias, 0, nCompTr);
+      } else {
+        coeff_cc.resize(gbox, nCompTr, amrex::The_Async_Arena());
+      }
       auto const& sar = S.array(mfi);
       auto const& qar = q.array();
       auto const& qauxar = qaux.array();
 
       // Get primitives, Q, including (Y, T, p, rho) from conserved state
-      {
+      if (!use_cache) {
         BL_PROFILE("PeleC::ctoprim()");
         amrex::ParallelFor(
           gbox, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
@@ -166,7 +208,7 @@ PeleC::getMOLSrcTerm(
 
       // Compute transport coefficients, coincident with Q
       auto const& coe_cc = coeff_cc.array();
-      {
+      if (add_diffusion && (!use_cache)) {
         auto const& qar_yin = q.array(QFS);
         auto const& qar_Tin = q.array(QTEMP);
         auto const& qar_rhoin = q.array(QRHO);
@@ -226,7 +268,7 @@ PeleC::getMOLSrcTerm(
       setV(cbox, NVAR, Dterm, 0.0);
       auto flag_arr = flags.const_array(mfi);
 
-      {
+      if (add_diffusion) {
         // Compute Extensive diffusion fluxes for X, Y, Z
         BL_PROFILE("PeleC::diffusion_flux()");
         const bool l_transport_harmonic_mean = transport_harmonic_mean;
@@ -261,7 +303,7 @@ PeleC::getMOLSrcTerm(
         }
       }
 
-      if (do_isothermal_walls) {
+      if (add_diffusion && do_isothermal_walls) {
         // Compute extensive diffusion flux at domain boundaries
         BL_PROFILE("PeleC::isothermal_wall_fluxes()");
         for (int dir = 0; dir < AMREX_SPACEDIM; dir++) {
@@ -328,7 +370,7 @@ PeleC::getMOLSrcTerm(
       }
 
       // Compute and add in the hydro fluxes.
-      if (do_hydro && do_mol) {
+      if (add_hydro && do_mol) {
         // amrex::FArrayBox flatn(cbox, 1, amrex::The_Async_Arena());
         // flatn.setVal(1.0); // Set flattening to 1.0
 
@@ -410,7 +452,8 @@ PeleC::getMOLSrcTerm(
           AMREX_ASSERT(Nvals == Ncut);
           AMREX_ASSERT(nFlux == Ncut);
 
-          if (eb_isothermal && (diffuse_temp || diffuse_enth)) {
+          if (
+            add_diffusion && eb_isothermal && (diffuse_temp || diffuse_enth)) {
             {
               BL_PROFILE("PeleC::pc_apply_eb_boundry_flux_stencil()");
               pc_apply_eb_boundry_flux_stencil(
@@ -421,7 +464,7 @@ PeleC::getMOLSrcTerm(
             }
           }
           // Compute momentum transfer at no-slip EB wall
-          if (eb_noslip && diffuse_vel) {
+          if (add_diffusion && eb_noslip && diffuse_vel) {
             {
               BL_PROFILE("PeleC::pc_apply_eb_boundry_visc_flux_stencil()");
               pc_apply_eb_boundry_visc_flux_stencil(
@@ -431,7 +474,7 @@ PeleC::getMOLSrcTerm(
                 eb_flux_thdlocal.dataPtr(Xmom), nFlux);
             }
           }
-          if (do_hydro && do_mol) {
+          if (add_hydro && do_mol) {
             { // Get hyp flux at EB wall
               BL_PROFILE("PeleC::pc_hyp_mol_flux_eb()");
               amrex::Real* d_eb_flux_thdlocal =
@@ -531,7 +574,9 @@ PeleC::getMOLSrcTerm(
       }
 
       // Extrapolate to GhostCells
-      if (MOLSrcTerm.nGrow() > 0) {
+      if (
+        (MOLSrcTerm.nGrow() > 0) && (ng_src == 0) &&
+        (region == MOLRegion::All)) {
         BL_PROFILE("PeleC::diffextrap()");
         const int mg = MOLSrcTerm.nGrow();
         const auto* low = vbox.loVect();
@@ -637,7 +682,12 @@ PeleC::getMOLSrcTerm(
       }
 
       // Refluxing
-      if (do_reflux && reflux_factor != 0) {
+      if (flux_store != nullptr) {
+        for (int dir = 0; dir < AMREX_SPACEDIM; dir++) {
+          (*flux_store)[dir][mfi].copy<amrex::RunOn::Device>(
+            flux_ec[dir], amrex::surroundingNodes(vbox, dir));
+        }
+      } else if (do_reflux && reflux_factor != 0) {
         if (typ == amrex::FabType::singlevalued) {
           for (int dir = 0; dir < AMREX_SPACEDIM; dir++) {
             const auto& ap = areafrac[dir]->const_array(mfi);
@@ -660,9 +710,93 @@ PeleC::getMOLSrcTerm(
 
       if (do_mol_load_balance && (cost != nullptr)) {
         amrex::Gpu::streamSynchronize();
-        wt = (amrex::ParallelDescriptor::second() - wt) / vbox.d_numPts();
-        (*cost)[mfi].plus<amrex::RunOn::Device>(wt, vbox);
+        wt = (amrex::ParallelDescriptor::second() - wt) / tbox.d_numPts();
+        (*cost)[mfi].plus<amrex::RunOn::Device>(wt, tbox);
       }
     }
   }
 }
+
+void
+PeleC::fill_and_get_mol_src(
+  amrex::MultiFab& S,
+  amrex::MultiFab& MOLSrcTerm,
+  const amrex::Real fill_time,
+  const int ng_fill,
+  const amrex::Real time,
+  const amrex::Real dt,
+  const amrex::Real reflux_factor,
+  const int terms)
+{
+  BL_PROFILE("PeleC::fill_and_get_mol_src()");
+
+  // On level 0 the fill is a copy of the state data, a halo exchange and the
+  // physical boundaries, so the exchange can run behind the interior work.
+  // The other levels interpolate ghost cells from the coarser level.
+  const bool overlap = mol_overlap_comm && (level == 0) && (!eb_in_domain) &&
+                       (!use_explicit_filter) && (MOLSrcTerm.nGrow() == 0);
+  if (!overlap) {
+    fill_stage_state(S, ng_fill, fill_time);
+    getMOLSrcTerm(S, MOLSrcTerm, time, dt, reflux_factor, terms);
+    return;
+  }
+
+  const amrex::Real t_new = state[State_Type].curTime();
+  const amrex::Real t_old = state[State_Type].prevTime();
+  const amrex::Real teps = (t_new - t_old) * 1.0e-3;
+  if (
+    (std::abs(fill_time - t_new) > teps) &&
+    (std::abs(fill_time - t_old) > teps)) {
+    amrex::Abort("PeleC::fill_and_get_mol_src: fill time is not a state time");
+  }
+  // The interior is computed before the halo is filled, without the cache
+  clear_prim_cache();
+  const amrex::MultiFab& S_state = (std::abs(fill_time - t_new) <= teps)
+                                     ? get_new_data(State_Type)
+                                     : get_old_data(State_Type);
+  amrex::MultiFab::Copy(S, S_state, 0, 0, NVAR, 0);
+  S.FillBoundary_nowait(0, NVAR, amrex::IntVect(ng_fill), geom.periodicity());
+
+  // The face fluxes of both passes are kept for a single flux register
+  // update per tile
+  const bool reflux = do_reflux && (reflux_factor != 0.0) &&
+                      (level < parent->finestLevel());
+  amrex::Array<amrex::MultiFab, AMREX_SPACEDIM> flux_store;
+  if (reflux) {
+    for (int dir = 0; dir < AMREX_SPACEDIM; dir++) {
+      flux_store[dir].define(
+        amrex::convert(grids, amrex::IntVect::TheDimensionVector(dir)), dmap,
+        NVAR, 0);
+    }
+  }
+  amrex::Array<amrex::MultiFab, AMREX_SPACEDIM>* store =
+    reflux ? &flux_store : nullptr;
+
+  getMOLSrcTerm(
+    S, MOLSrcTerm, time, dt, reflux_factor, terms, 0, MOLRegion::Interior,
+    store);
+
+  S.FillBoundary_finish();
+  for (amrex::MFIter mfi(S); mfi.isValid(); ++mfi) {
+    state[State_Type].FillBoundary(
+      S[mfi], fill_time, geom.CellSize(), geom.ProbDomain(), 0, 0, NVAR);
+  }
+
+  for (int slab = 0; slab < 2 * AMREX_SPACEDIM; slab++) {
+    getMOLSrcTerm(
+      S, MOLSrcTerm, time, dt, reflux_factor, terms, 0,
+      MOLRegion::Shell + slab, store);
+  }
+
+  if (reflux) {
+    amrex::FArrayBox dm_as_fine(
+      amrex::Box::TheUnitBox(), NVAR, amrex::The_Async_Arena());
+    for (amrex::MFIter mfi(S); mfi.isValid(); ++mfi) {
+      update_flux_registers(
+        reflux_factor * dt, mfi, amrex::FabType::regular,
+        {AMREX_D_DECL(
+          &flux_store[0][mfi], &flux_store[1][mfi], &flux_store[2][mfi])},
+        dm_as_fine);
+    }
+  }
+}
@@ -1,6 +1,8 @@
 #include "Godunov.H"
 #include "PLM.H"
 #include "PPM.H"
+#include "Utilities.H"
+#include "ScratchArena.H"
 
 // Host function that overwrites fluxes with lower-order approximation
 void
@@ -23,8 +25,8 @@ pc_low_order_boundary(
   // Compute left and right states
   amrex::Box bdbx = enclosedCells(bfbx).grow(idir, 1);
   amrex::Box bdbx2 = growHi(bdbx, idir, 1);
-  amrex::FArrayBox qbm(bdbx2, QVAR, amrex::The_Async_Arena());
-  amrex::FArrayBox qbp(bdbx, QVAR, amrex::The_Async_Arena());
+  amrex::FArrayBox qbm(bdbx2, QVAR, pc_scratch_arena());
+  amrex::FArrayBox qbp(bdbx, QVAR, pc_scratch_arena());
   auto const& qbmarr = qbm.array();
   auto const& qbparr = qbp.array();
   amrex::ParallelFor(bdbx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
@@ -48,11 +50,187 @@ pc_low_order_boundary(
   });
 
   // Recompute fluxes
-  amrex::ParallelFor(bfbx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
-    pc_cmpflx(
-      i, j, k, bclo, bchi, domlo, domhi, qbmarr, qbparr, flx, qdir, qa, idir);
+  pc_cmpflx_batch(
+    bfbx, bclo, bchi, domlo, domhi, qbmarr, qbparr, flx, qdir, qa, idir);
+}
+
+// Host function for the Riemann fluxes of the faces of bx. On CPUs the
+// faces of each pencil along i are solved together by riemann_batch.
+void
+pc_cmpflx_batch(
+  amrex::Box const& bx,
+  const int bclo,
+  const int bchi,
+  const int domlo,
+  const int domhi,
+  amrex::Array4<const amrex::Real> const& ql,
+  amrex::Array4<const amrex::Real> const& qr,
+  amrex::Array4<amrex::Real> const& flx,
+  amrex::Array4<amrex::Real> const& q,
+  amrex::Array4<const amrex::Real> const& qa,
+  const int dir)
+{
+#ifdef AMREX_USE_GPU
+  amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
+    pc_cmpflx(i, j, k, bclo, bchi, domlo, domhi, ql, qr, flx, q, qa, dir);
+  });
+#else
+  constexpr int B = riemann_batch_size;
+  const int bc_test_val = 1;
+  const int IU = (dir == 0) ? QU : ((dir == 1) ? QV : QW);
+  const int IV = (dir == 0) ? QV : QU;
+  const int IV2 = (dir == 2) ? QV : QW;
+  const int GU = (dir == 0) ? GDU : ((dir == 1) ? GDV : GDW);
+  const int GV = (dir == 0) ? GDV : GDU;
+  const int GV2 = (dir == 2) ? GDV : GDW;
+  const int f_idx[3] = {
+    (dir == 0) ? UMX : ((dir == 1) ? UMY : UMZ), (dir == 0) ? UMY : UMX,
+    (dir == 2) ? UMY : UMZ};
+  const amrex::IntVect ivd = amrex::IntVect::TheDimensionVector(dir);
+  const auto lo = amrex::lbound(bx);
+  const auto hi = amrex::ubound(bx);
+
+  RiemannBatch b;
+  for (int k = lo.z; k <= hi.z; ++k) {
+    for (int j = lo.y; j <= hi.y; ++j) {
+      for (int i0 = lo.x; i0 <= hi.x; i0 += B) {
+        b.n = amrex::min(B, hi.x - i0 + 1);
+        for (int f = 0; f < b.n; ++f) {
+          const int i = i0 + f;
+          const amrex::IntVect iv{AMREX_D_DECL(i, j, k)};
+          b.cav[f] = 0.5 * (qa(iv, QC) + qa(iv - ivd, QC));
+          b.rl[f] = ql(iv, QRHO);
+          b.ul[f] = ql(iv, IU);
+          b.vl[f] = ql(iv, IV);
+          b.v2l[f] = ql(iv, IV2);
+          b.pl[f] = ql(iv, QPRES);
+          b.rr[f] = qr(iv, QRHO);
+          b.ur[f] = qr(iv, IU);
+          b.vr[f] = qr(iv, IV);
+          b.v2r[f] = qr(iv, IV2);
+          b.pr[f] = qr(iv, QPRES);
+          for (int sp = 0; sp < NUM_SPECIES; ++sp) {
+            b.spl[sp][f] = ql(iv, QFS + sp);
+            b.spr[sp][f] = qr(iv, QFS + sp);
+          }
+          const int idx = (dir == 0) ? i : ((dir == 1) ? j : k);
+          pc_cmpflx_bc(
+            idx, bclo, bchi, domlo, domhi, b.rl[f], b.ul[f], b.vl[f],
+            b.v2l[f], b.pl[f], b.rr[f], b.ur[f], b.vr[f], b.v2r[f], b.pr[f]);
+        }
+
+        riemann_batch(b, bc_test_val, false);
+
+        for (int f = 0; f < b.n; ++f) {
+          const amrex::IntVect iv{AMREX_D_DECL(i0 + f, j, k)};
+          const amrex::Real ustar = b.ustar[f];
+          const amrex::Real flxrho = b.uflx_rho[f];
+          flx(iv, URHO) = flxrho;
+          flx(iv, f_idx[0]) = b.uflx_u[f];
+          flx(iv, f_idx[1]) = b.uflx_v[f];
+          flx(iv, f_idx[2]) = b.uflx_w[f];
+          flx(iv, UEDEN) = b.uflx_eden[f];
+          flx(iv, UEINT) = b.uflx_eint[f];
+          q(iv, GU) = b.qint_iu[f];
+          q(iv, GV) = b.qint_iv1[f];
+          q(iv, GV2) = b.qint_iv2[f];
+          q(iv, GDPRES) = b.qint_gdpres[f];
+          q(iv, GDGAME) = b.qint_gdgame[f];
+#if NUM_ADV > 0
+          for (int n = 0; n < NUM_ADV; n++) {
+            const int qc = QFA + n;
+            pc_cmpflx_passive(
+              ustar, flxrho, ql(iv, qc), qr(iv, qc), flx(iv, UFA + n));
+          }
+#endif
+          for (int n = 0; n < NUM_SPECIES; n++) {
+            const int qc = QFS + n;
+            pc_cmpflx_passive(
+              ustar, flxrho, ql(iv, qc), qr(iv, qc), flx(iv, UFS + n));
+          }
+#if NUM_AUX > 0
+          for (int n = 0; n < NUM_AUX; n++) {
+            const int qc = QFX + n;
+            pc_cmpflx_passive(
+              ustar, flxrho, ql(iv, qc), qr(iv, qc), flx(iv, UFX + n));
+          }
+#endif
+#if NUM_LIN > 0
+          for (int n = 0; n < NUM_LIN; n++) {
+            const int qc = QLIN + n;
+            pc_cmpflx_passive(
+              ustar, q(iv, GU), ql(iv, qc), qr(iv, qc), flx(iv, ULIN + n));
+          }
+#endif
+        }
+      }
+    }
+  }
+#endif
+}
+
+namespace {
+// PLM slopes and normal predictor states of the cells of bx in every
+// direction, specialized on the slope order and on flattening. The slopes
+// and the states are computed in the same kernel launch to avoid
+// unnecessary launches.
+template <int PLMIorder, bool UseFlattening>
+void
+pc_plm_states(
+  amrex::Box const& bx,
+  amrex::Array4<const amrex::Real> const& q,
+  amrex::Array4<const amrex::Real> const& qaux,
+  const amrex::GpuArray<amrex::Array4<amrex::Real>, AMREX_SPACEDIM>& qm,
+  const amrex::GpuArray<amrex::Array4<amrex::Real>, AMREX_SPACEDIM>& qp,
+  const amrex::GpuArray<amrex::Real, AMREX_SPACEDIM>& del,
+  const amrex::Real dt)
+{
+  amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
+    amrex::Real slope[QVAR] = {0.0};
+
+    amrex::Real flat = 1.0;
+    // Calculate flattening in-place
+    if constexpr (UseFlattening) {
+      for (int dir_flat = 0; dir_flat < AMREX_SPACEDIM; dir_flat++) {
+        flat = amrex::min<amrex::Real>(
+          flat, flatten(AMREX_D_DECL(i, j, k), dir_flat, q));
+      }
+    }
+
+    for (int idir = 0; idir < AMREX_SPACEDIM; idir++) {
+      if constexpr (PLMIorder != 1) {
+        for (int n = 0; n < QVAR; ++n) {
+          slope[n] =
+            plm_slope<PLMIorder>(AMREX_D_DECL(i, j, k), n, idir, q, flat);
+        }
+      }
+      pc_plm_d(
+        AMREX_D_DECL(i, j, k), idir, qm[idir], qp[idir], slope, q,
+        qaux(i, j, k, QC), del[idir], dt);
+    }
+  });
+}
+
+void
+pc_plm_states(
+  amrex::Box const& bx,
+  amrex::Array4<const amrex::Real> const& q,
+  amrex::Array4<const amrex::Real> const& qaux,
+  const amrex::GpuArray<amrex::Array4<amrex::Real>, AMREX_SPACEDIM>& qm,
+  const amrex::GpuArray<amrex::Array4<amrex::Real>, AMREX_SPACEDIM>& qp,
+  const amrex::GpuArray<amrex::Real, AMREX_SPACEDIM>& del,
+  const amrex::Real dt,
+  const int plm_iorder,
+  const bool use_flattening)
+{
+  pc_static_dispatch<1, 2, 4>(plm_iorder, [&](auto order) {
+    pc_static_dispatch<0, 1>(static_cast<int>(use_flattening), [&](auto flat) {
+      pc_plm_states<decltype(order)::value, decltype(flat)::value == 1>(
+        bx, q, qaux, qm, qp, del, dt);
+    });
   });
 }
+} // namespace
 
 // Host function to call gpu hydro functions
 #if AMREX_SPACEDIM == 3
@@ -110,8 +288,8 @@ pc_umeth_3D(
   int cdir = 0;
   const amrex::Box& xmbx = growHi(bxg2, cdir, 1);
   const amrex::Box& xflxbx = surroundingNodes(grow(bxg2, cdir, -1), cdir);
-  amrex::FArrayBox qxm(xmbx, QVAR, amrex::The_Async_Arena());
-  amrex::FArrayBox qxp(bxg2, QVAR, amrex::The_Async_Arena());
+  amrex::FArrayBox qxm(xmbx, QVAR, pc_scratch_arena());
+  amrex::FArrayBox qxp(bxg2, QVAR, pc_scratch_arena());
   auto const& qxmarr = qxm.array();
   auto const& qxparr = qxp.array();
 
@@ -119,8 +297,8 @@ pc_umeth_3D(
   cdir = 1;
   const amrex::Box& ymbx = growHi(bxg2, cdir, 1);
   const amrex::Box& yflxbx = surroundingNodes(grow(bxg2, cdir, -1), cdir);
-  amrex::FArrayBox qym(ymbx, QVAR, amrex::The_Async_Arena());
-  amrex::FArrayBox qyp(bxg2, QVAR, amrex::The_Async_Arena());
+  amrex::FArrayBox qym(ymbx, QVAR, pc_scratch_arena());
+  amrex::FArrayBox qyp(bxg2, QVAR, pc_scratch_arena());
   auto const& qymarr = qym.array();
   auto const& qyparr = qyp.array();
 
@@ -128,56 +306,15 @@ pc_umeth_3D(
   cdir = 2;
   const amrex::Box& zmbx = growHi(bxg2, cdir, 1);
   const amrex::Box& zflxbx = surroundingNodes(grow(bxg2, cdir, -1), cdir);
-  amrex::FArrayBox qzm(zmbx, QVAR, amrex::The_Async_Arena());
-  amrex::FArrayBox qzp(bxg2, QVAR, amrex::The_Async_Arena());
+  amrex::FArrayBox qzm(zmbx, QVAR, pc_scratch_arena());
+  amrex::FArrayBox qzp(bxg2, QVAR, pc_scratch_arena());
   auto const& qzmarr = qzm.array();
   auto const& qzparr = qzp.array();
 
-  // Put the PLM and slopes in the same kernel launch to avoid unnecessary
-  // launch
   if (ppm_type == 0) {
-    amrex::ParallelFor(
-      bxg2, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
-        amrex::Real slope[QVAR];
-
-        amrex::Real flat = 1.0;
-        // Calculate flattening in-place
-        if (use_flattening) {
-          for (int dir_flat = 0; dir_flat < AMREX_SPACEDIM; dir_flat++) {
-            flat = amrex::min<amrex::Real>(flat, flatten(i, j, k, dir_flat, q));
-          }
-        }
-
-        // X slopes and interp
-        int idir = 0;
-        for (int n = 0; n < QVAR; ++n) {
-          slope[n] =
-            plm_slope(AMREX_D_DECL(i, j, k), n, 0, q, flat, plm_iorder);
-        }
-        pc_plm_d(
-          AMREX_D_DECL(i, j, k), idir, qxmarr, qxparr, slope, q,
-          qaux(i, j, k, QC), dx, dt);
-
-        // Y slopes and interp
-        idir = 1;
-        for (int n = 0; n < QVAR; n++) {
-          slope[n] =
-            plm_slope(AMREX_D_DECL(i, j, k), n, 1, q, flat, plm_iorder);
-        }
-        pc_plm_d(
-          AMREX_D_DECL(i, j, k), idir, qymarr, qyparr, slope, q,
-          qaux(i, j, k, QC), dy, dt);
-
-        // Z slopes and interp
-        idir = 2;
-        for (int n = 0; n < QVAR; ++n) {
-          slope[n] =
-            plm_slope(AMREX_D_DECL(i, j, k), n, 2, q, flat, plm_iorder);
-        }
-        pc_plm_d(
-          AMREX_D_DECL(i, j, k), idir, qzmarr, qzparr, slope, q,
-          qaux(i, j, k, QC), dz, dt);
-      });
+    pc_plm_states(
+      bxg2, q, qaux, {qxmarr, qymarr, qzmarr}, {qxparr, qyparr, qzparr}, del,
+      dt, plm_iorder, use_flattening);
   } else if (ppm_type == 1) {
     // Compute the normal interface states by reconstructing
     // the primitive variables using the piecewise parabolic method
@@ -206,186 +343,178 @@ pc_umeth_3D(
   // These are the first flux estimates as per the corner-transport-upwind
   // method X initial fluxes
   cdir = 0;
-  amrex::FArrayBox fx(xflxbx, NVAR, amrex::The_Async_Arena());
+  amrex::FArrayBox fx(xflxbx, NVAR, pc_scratch_arena());
   auto const& fxarr = fx.array();
-  amrex::FArrayBox qgdx(xflxbx, NGDNV, amrex::The_Async_Arena());
+  amrex::FArrayBox qgdx(xflxbx, NGDNV, pc_scratch_arena());
   auto const& gdtempx = qgdx.array();
-  amrex::ParallelFor(
-    xflxbx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
-      pc_cmpflx(
-        i, j, k, bclx, bchx, dlx, dhx, qxmarr, qxparr, fxarr, gdtempx, qaux,
-        cdir);
-    });
+  pc_cmpflx_batch(
+    xflxbx, bclx, bchx, dlx, dhx, qxmarr, qxparr, fxarr, gdtempx, qaux, cdir);
 
   // Y initial fluxes
   cdir = 1;
-  amrex::FArrayBox fy(yflxbx, NVAR, amrex::The_Async_Arena());
+  amrex::FArrayBox fy(yflxbx, NVAR, pc_scratch_arena());
   auto const& fyarr = fy.array();
-  amrex::FArrayBox qgdy(yflxbx, NGDNV, amrex::The_Async_Arena());
+  amrex::FArrayBox qgdy(yflxbx, NGDNV, pc_scratch_arena());
   auto const& gdtempy = qgdy.array();
-  amrex::ParallelFor(
-    yflxbx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
-      pc_cmpflx(
-        i, j, k, bcly, bchy, dly, dhy, qymarr, qyparr, fyarr, gdtempy, qaux,
-        cdir);
-    });
+  pc_cmpflx_batch(
+    yflxbx, bcly, bchy, dly, dhy, qymarr, qyparr, fyarr, gdtempy, qaux, cdir);
 
   // Z initial fluxes
   cdir = 2;
-  amrex::FArrayBox fz(zflxbx, NVAR, amrex::The_Async_Arena());
+  amrex::FArrayBox fz(zflxbx, NVAR, pc_scratch_arena());
   auto const& fzarr = fz.array();
-  amrex::FArrayBox qgdz(zflxbx, NGDNV, amrex::The_Async_Arena());
+  amrex::FArrayBox qgdz(zflxbx, NGDNV, pc_scratch_arena());
   auto const& gdtempz = qgdz.array();
-  amrex::ParallelFor(
-    zflxbx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
-      pc_cmpflx(
-        i, j, k, bclz, bchz, dlz, dhz, qzmarr, qzparr, fzarr, gdtempz, qaux,
-        cdir);
-    });
+  pc_cmpflx_batch(
+    zflxbx, bclz, bchz, dlz, dhz, qzmarr, qzparr, fzarr, gdtempz, qaux, cdir);
+
+  // Interface corrections. The predicted states of each direction are only
+  // needed by its Riemann problems, so they are released before the next
+  // direction and the three directions share the same scratch storage.
 
   // X interface corrections
   cdir = 0;
   const amrex::Box& txbx = grow(bxg1, cdir, 1);
   const amrex::Box& txbxm = growHi(txbx, cdir, 1);
-  amrex::FArrayBox qxym(txbxm, QVAR, amrex::The_Async_Arena());
-  amrex::FArrayBox qxyp(txbx, QVAR, amrex::The_Async_Arena());
-  auto const& qmxy = qxym.array();
-  auto const& qpxy = qxyp.array();
-
-  amrex::FArrayBox qxzm(txbxm, QVAR, amrex::The_Async_Arena());
-  amrex::FArrayBox qxzp(txbx, QVAR, amrex::The_Async_Arena());
-  auto const& qmxz = qxzm.array();
-  auto const& qpxz = qxzp.array();
-
-  amrex::ParallelFor(txbx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
-    // X|Y
-    pc_transdo(
-      AMREX_D_DECL(i, j, k), cdir, 1, qmxy, qpxy, qxmarr, qxparr, fyarr, qaux,
-      gdtempy, cdtdy);
-    // X|Z
-    pc_transdo(
-      AMREX_D_DECL(i, j, k), cdir, 2, qmxz, qpxz, qxmarr, qxparr, fzarr, qaux,
-      gdtempz, cdtdz);
-  });
-
   const amrex::Box& txfxbx = surroundingNodes(bxg1, cdir);
-  amrex::FArrayBox fluxxy(txfxbx, NVAR, amrex::The_Async_Arena());
-  amrex::FArrayBox fluxxz(txfxbx, NVAR, amrex::The_Async_Arena());
-  amrex::FArrayBox gdvxyfab(txfxbx, NGDNV, amrex::The_Async_Arena());
-  amrex::FArrayBox gdvxzfab(txfxbx, NGDNV, amrex::The_Async_Arena());
+  amrex::FArrayBox fluxxy(txfxbx, NVAR, pc_scratch_arena());
+  amrex::FArrayBox fluxxz(txfxbx, NVAR, pc_scratch_arena());
+  amrex::FArrayBox gdvxyfab(txfxbx, NGDNV, pc_scratch_arena());
+  amrex::FArrayBox gdvxzfab(txfxbx, NGDNV, pc_scratch_arena());
 
   auto const& flxy = fluxxy.array();
   auto const& flxz = fluxxz.array();
   auto const& qxy = gdvxyfab.array();
   auto const& qxz = gdvxzfab.array();
 
-  // Riemann problem X|Y X|Z
-  amrex::ParallelFor(
-    txfxbx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
-      // X|Y
-      pc_cmpflx(
-        i, j, k, bclx, bchx, dlx, dhx, qmxy, qpxy, flxy, qxy, qaux, cdir);
-      // X|Z
-      pc_cmpflx(
-        i, j, k, bclx, bchx, dlx, dhx, qmxz, qpxz, flxz, qxz, qaux, cdir);
-    });
+  {
+    amrex::FArrayBox qxym(txbxm, QVAR, pc_scratch_arena());
+    amrex::FArrayBox qxyp(txbx, QVAR, pc_scratch_arena());
+    auto const& qmxy = qxym.array();
+    auto const& qpxy = qxyp.array();
+
+    amrex::FArrayBox qxzm(txbxm, QVAR, pc_scratch_arena());
+    amrex::FArrayBox qxzp(txbx, QVAR, pc_scratch_arena());
+    auto const& qmxz = qxzm.array();
+    auto const& qpxz = qxzp.array();
+
+    amrex::ParallelFor(
+      txbx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
+        // X|Y
+        pc_transdo(
+          AMREX_D_DECL(i, j, k), cdir, 1, qmxy, qpxy, qxmarr, qxparr, fyarr,
+          qaux, gdtempy, cdtdy);
+        // X|Z
+        pc_transdo(
+          AMREX_D_DECL(i, j, k), cdir, 2, qmxz, qpxz, qxmarr, qxparr, fzarr,
+          qaux, gdtempz, cdtdz);
+      });
+
+    // Riemann problem X|Y X|Z
+    // X|Y
+    pc_cmpflx_batch(
+      txfxbx, bclx, bchx, dlx, dhx, qmxy, qpxy, flxy, qxy, qaux, cdir);
+    // X|Z
+    pc_cmpflx_batch(
+      txfxbx, bclx, bchx, dlx, dhx, qmxz, qpxz, flxz, qxz, qaux, cdir);
+  }
 
   // Y interface corrections
   cdir = 1;
   const amrex::Box& tybx = grow(bxg1, cdir, 1);
   const amrex::Box& tybxm = growHi(tybx, cdir, 1);
-  amrex::FArrayBox qyxm(tybxm, QVAR, amrex::The_Async_Arena());
-  amrex::FArrayBox qyxp(tybx, QVAR, amrex::The_Async_Arena());
-  amrex::FArrayBox qyzm(tybxm, QVAR, amrex::The_Async_Arena());
-  amrex::FArrayBox qyzp(tybx, QVAR, amrex::The_Async_Arena());
-  auto const& qmyx = qyxm.array();
-  auto const& qpyx = qyxp.array();
-  auto const& qmyz = qyzm.array();
-  auto const& qpyz = qyzp.array();
-
-  amrex::ParallelFor(tybx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
-    // Y|X
-    pc_transdo(
-      AMREX_D_DECL(i, j, k), cdir, 0, qmyx, qpyx, qymarr, qyparr, fxarr, qaux,
-      gdtempx, cdtdx);
-    // Y|Z
-    pc_transdo(
-      AMREX_D_DECL(i, j, k), cdir, 2, qmyz, qpyz, qymarr, qyparr, fzarr, qaux,
-      gdtempz, cdtdz);
-  });
-
-  // Riemann problem Y|X Y|Z
   const amrex::Box& tyfxbx = surroundingNodes(bxg1, cdir);
-  amrex::FArrayBox fluxyx(tyfxbx, NVAR, amrex::The_Async_Arena());
-  amrex::FArrayBox fluxyz(tyfxbx, NVAR, amrex::The_Async_Arena());
-  amrex::FArrayBox gdvyxfab(tyfxbx, NGDNV, amrex::The_Async_Arena());
-  amrex::FArrayBox gdvyzfab(tyfxbx, NGDNV, amrex::The_Async_Arena());
+  amrex::FArrayBox fluxyx(tyfxbx, NVAR, pc_scratch_arena());
+  amrex::FArrayBox fluxyz(tyfxbx, NVAR, pc_scratch_arena());
+  amrex::FArrayBox gdvyxfab(tyfxbx, NGDNV, pc_scratch_arena());
+  amrex::FArrayBox gdvyzfab(tyfxbx, NGDNV, pc_scratch_arena());
 
   auto const& flyx = fluxyx.array();
   auto const& flyz = fluxyz.array();
   auto const& qyx = gdvyxfab.array();
   auto const& qyz = gdvyzfab.array();
 
-  amrex::ParallelFor(
-    tyfxbx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
-      // Y|X
-      pc_cmpflx(
-        i, j, k, bcly, bchy, dly, dhy, qmyx, qpyx, flyx, qyx, qaux, cdir);
-      // Y|Z
-      pc_cmpflx(
-        i, j, k, bcly, bchy, dly, dhy, qmyz, qpyz, flyz, qyz, qaux, cdir);
-    });
+  {
+    amrex::FArrayBox qyxm(tybxm, QVAR, pc_scratch_arena());
+    amrex::FArrayBox qyxp(tybx, QVAR, pc_scratch_arena());
+    amrex::FArrayBox qyzm(tybxm, QVAR, pc_scratch_arena());
+    amrex::FArrayBox qyzp(tybx, QVAR, pc_scratch_arena());
+    auto const& qmyx = qyxm.array();
+    auto const& qpyx = qyxp.array();
+    auto const& qmyz = qyzm.array();
+    auto const& qpyz = qyzp.array();
+
+    amrex::ParallelFor(
+      tybx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
+        // Y|X
+        pc_transdo(
+          AMREX_D_DECL(i, j, k), cdir, 0, qmyx, qpyx, qymarr, qyparr, fxarr,
+          qaux, gdtempx, cdtdx);
+        // Y|Z
+        pc_transdo(
+          AMREX_D_DECL(i, j, k), cdir, 2, qmyz, qpyz, qymarr, qyparr, fzarr,
+          qaux, gdtempz, cdtdz);
+      });
+
+    // Riemann problem Y|X Y|Z
+    // Y|X
+    pc_cmpflx_batch(
+      tyfxbx, bcly, bchy, dly, dhy, qmyx, qpyx, flyx, qyx, qaux, cdir);
+    // Y|Z
+    pc_cmpflx_batch(
+      tyfxbx, bcly, bchy, dly, dhy, qmyz, qpyz, flyz, qyz, qaux, cdir);
+  }
 
   // Z interface corrections
   cdir = 2;
   const amrex::Box& tzbx = grow(bxg1, cdir, 1);
   const amrex::Box& tzbxm = growHi(tzbx, cdir, 1);
-  amrex::FArrayBox qzxm(tzbxm, QVAR, amrex::The_Async_Arena());
-  amrex::FArrayBox qzxp(tzbx, QVAR, amrex::The_Async_Arena());
-  amrex::FArrayBox qzym(tzbxm, QVAR, amrex::The_Async_Arena());
-  amrex::FArrayBox qzyp(tzbx, QVAR, amrex::The_Async_Arena());
-
-  auto const& qmzx = qzxm.array();
-  auto const& qpzx = qzxp.array();
-  auto const& qmzy = qzym.array();
-  auto const& qpzy = qzyp.array();
-
-  amrex::ParallelFor(tzbx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
-    // Z|X
-    pc_transdo(
-      AMREX_D_DECL(i, j, k), cdir, 0, qmzx, qpzx, qzmarr, qzparr, fxarr, qaux,
-      gdtempx, cdtdx);
-    // Z|Y
-    pc_transdo(
-      AMREX_D_DECL(i, j, k), cdir, 1, qmzy, qpzy, qzmarr, qzparr, fyarr, qaux,
-      gdtempy, cdtdy);
-  });
-
-  // Riemann problem Z|X Z|Y
   const amrex::Box& tzfxbx = surroundingNodes(bxg1, cdir);
-  amrex::FArrayBox fluxzx(tzfxbx, NVAR, amrex::The_Async_Arena());
-  amrex::FArrayBox fluxzy(tzfxbx, NVAR, amrex::The_Async_Arena());
-  amrex::FArrayBox gdvzxfab(tzfxbx, NGDNV, amrex::The_Async_Arena());
-  amrex::FArrayBox gdvzyfab(tzfxbx, NGDNV, amrex::The_Async_Arena());
+  amrex::FArrayBox fluxzx(tzfxbx, NVAR, pc_scratch_arena());
+  amrex::FArrayBox fluxzy(tzfxbx, NVAR, pc_scratch_arena());
+  amrex::FArrayBox gdvzxfab(tzfxbx, NGDNV, pc_scratch_arena());
+  amrex::FArrayBox gdvzyfab(tzfxbx, NGDNV, pc_scratch_arena());
 
   auto const& flzx = fluxzx.array();
   auto const& flzy = fluxzy.array();
   auto const& qzx = gdvzxfab.array();
   auto const& qzy = gdvzyfab.array();
 
-  amrex::ParallelFor(
-    tzfxbx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
-      // Z|X
-      pc_cmpflx(
-        i, j, k, bclz, bchz, dlz, dhz, qmzx, qpzx, flzx, qzx, qaux, cdir);
-      // Z|Y
-      pc_cmpflx(
-        i, j, k, bclz, bchz, dlz, dhz, qmzy, qpzy, flzy, qzy, qaux, cdir);
-    });
+  {
+    amrex::FArrayBox qzxm(tzbxm, QVAR, pc_scratch_arena());
+    amrex::FArrayBox qzxp(tzbx, QVAR, pc_scratch_arena());
+    amrex::FArrayBox qzym(tzbxm, QVAR, pc_scratch_arena());
+    amrex::FArrayBox qzyp(tzbx, QVAR, pc_scratch_arena());
+
+    auto const& qmzx = qzxm.array();
+    auto const& qpzx = qzxp.array();
+    auto const& qmzy = qzym.array();
+    auto const& qpzy = qzyp.array();
+
+    amrex::ParallelFor(
+      tzbx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
+        // Z|X
+        pc_transdo(
+          AMREX_D_DECL(i, j, k), cdir, 0, qmzx, qpzx, qzmarr, qzparr, fxarr,
+          qaux, gdtempx, cdtdx);
+        // Z|Y
+        pc_transdo(
+          AMREX_D_DECL(i, j, k), cdir, 1, qmzy, qpzy, qzmarr, qzparr, fyarr,
+          qaux, gdtempy, cdtdy);
+      });
+
+    // Riemann problem Z|X Z|Y
+    // Z|X
+    pc_cmpflx_batch(
+      tzfxbx, bclz, bchz, dlz, dhz, qmzx, qpzx, flzx, qzx, qaux, cdir);
+    // Z|Y
+    pc_cmpflx_batch(
+      tzfxbx, bclz, bchz, dlz, dhz, qmzy, qpzy, flzy, qzy, qaux, cdir);
+  }
 
   // Temp Fabs for Final Fluxes
-  amrex::FArrayBox qmfab(bxg2, QVAR, amrex::The_Async_Arena());
-  amrex::FArrayBox qpfab(bxg1, QVAR, amrex::The_Async_Arena());
+  amrex::FArrayBox qmfab(bxg2, QVAR, pc_scratch_arena());
+  amrex::FArrayBox qpfab(bxg1, QVAR, pc_scratch_arena());
   auto const& qm = qmfab.array();
   auto const& qp = qpfab.array();
 
@@ -400,10 +529,8 @@ pc_umeth_3D(
   });
 
   // Final X flux
-  amrex::ParallelFor(xfxbx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
-    pc_cmpflx(
-      i, j, k, bclx, bchx, dlx, dhx, qm, qp, flx[0], qec[0], qaux, cdir);
-  });
+  pc_cmpflx_batch(
+    xfxbx, bclx, bchx, dlx, dhx, qm, qp, flx[0], qec[0], qaux, cdir);
 
   // Y | X&Z
   cdir = 1;
@@ -416,10 +543,8 @@ pc_umeth_3D(
   });
 
   // Final Y flux
-  amrex::ParallelFor(yfxbx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
-    pc_cmpflx(
-      i, j, k, bcly, bchy, dly, dhy, qm, qp, flx[1], qec[1], qaux, cdir);
-  });
+  pc_cmpflx_batch(
+    yfxbx, bcly, bchy, dly, dhy, qm, qp, flx[1], qec[1], qaux, cdir);
 
   // Z | X&Y
   cdir = 2;
@@ -432,10 +557,8 @@ pc_umeth_3D(
   });
 
   // Final Z flux
-  amrex::ParallelFor(zfxbx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
-    pc_cmpflx(
-      i, j, k, bclz, bchz, dlz, dhz, qm, qp, flx[2], qec[2], qaux, cdir);
-  });
+  pc_cmpflx_batch(
+    zfxbx, bclz, bchz, dlz, dhz, qm, qp, flx[2], qec[2], qaux, cdir);
 
   // Fix bcnormal boundaries - always use PLM and don't do N+1/2 predictor
   // because the user specifies conditions at N
@@ -528,25 +651,25 @@ pc_umeth_eb_3D(
   // X data
   cdir = 0;
   const amrex::Box& xmbx = growHi(bxg2, cdir, 1);
-  amrex::FArrayBox qxm(xmbx, QVAR, amrex::The_Async_Arena());
+  amrex::FArrayBox qxm(xmbx, QVAR, pc_scratch_arena());
   auto const& qxmarr = qxm.array();
-  amrex::FArrayBox qxp(bxg2, QVAR, amrex::The_Async_Arena());
+  amrex::FArrayBox qxp(bxg2, QVAR, pc_scratch_arena());
   auto const& qxparr = qxp.array();
 
   // Y data
   cdir = 1;
   const amrex::Box& ymbx = growHi(bxg2, cdir, 1);
-  amrex::FArrayBox qym(ymbx, QVAR, amrex::The_Async_Arena());
+  amrex::FArrayBox qym(ymbx, QVAR, pc_scratch_arena());
   auto const& qymarr = qym.array();
-  amrex::FArrayBox qyp(bxg2, QVAR, amrex::The_Async_Arena());
+  amrex::FArrayBox qyp(bxg2, QVAR, pc_scratch_arena());
   auto const& qyparr = qyp.array();
 
   // Z data
   cdir = 2;
   const amrex::Box& zmbx = growHi(bxg2, cdir, 1);
-  amrex::FArrayBox qzm(zmbx, QVAR, amrex::The_Async_Arena());
+  amrex::FArrayBox qzm(zmbx, QVAR, pc_scratch_arena());
   auto const& qzmarr = qzm.array();
-  amrex::FArrayBox qzp(bxg2, QVAR, amrex::The_Async_Arena());
+  amrex::FArrayBox qzp(bxg2, QVAR, pc_scratch_arena());
   auto const& qzparr = qzp.array();
   //
   // Put the PLM and slopes in the same kernel launch to avoid unnecessary
@@ -616,10 +739,10 @@ pc_umeth_eb_3D(
   cdir = 0;
   const amrex::Box& xflxbx = surroundingNodes(grow(bxg2, cdir, -1), cdir);
 
-  amrex::FArrayBox fx(xflxbx, NVAR, amrex::The_Async_Arena());
+  amrex::FArrayBox fx(xflxbx, NVAR, pc_scratch_arena());
   auto const& fxarr = fx.array();
 
-  amrex::FArrayBox qgdx(xflxbx, NGDNV, amrex::The_Async_Arena());
+  amrex::FArrayBox qgdx(xflxbx, NGDNV, pc_scratch_arena());
   auto const& gdtempx = qgdx.array();
 
   // -4,-5,-5
@@ -638,10 +761,10 @@ pc_umeth_eb_3D(
   cdir = 1;
   const amrex::Box& yflxbx = surroundingNodes(grow(bxg2, cdir, -1), cdir);
 
-  amrex::FArrayBox fy(yflxbx, NVAR, amrex::The_Async_Arena());
+  amrex::FArrayBox fy(yflxbx, NVAR, pc_scratch_arena());
   auto const& fyarr = fy.array();
 
-  amrex::FArrayBox qgdy(yflxbx, NGDNV, amrex::The_Async_Arena());
+  amrex::FArrayBox qgdy(yflxbx, NGDNV, pc_scratch_arena());
   auto const& gdtempy = qgdy.array();
 
   // -5,-4,-5
@@ -660,10 +783,10 @@ pc_umeth_eb_3D(
   cdir = 2;
   const amrex::Box& zflxbx = surroundingNodes(grow(bxg2, cdir, -1), cdir);
 
-  amrex::FArrayBox fz(zflxbx, NVAR, amrex::The_Async_Arena());
+  amrex::FArrayBox fz(zflxbx, NVAR, pc_scratch_arena());
   auto const& fzarr = fz.array();
 
-  amrex::FArrayBox qgdz(zflxbx, NGDNV, amrex::The_Async_Arena());
+  amrex::FArrayBox qgdz(zflxbx, NGDNV, pc_scratch_arena());
   auto const& gdtempz = qgdz.array();
 
   // -5,-5,-4
@@ -680,13 +803,13 @@ pc_umeth_eb_3D(
   // X interface corrections
   // *************************************************************************************
   cdir = 0;
-  amrex::FArrayBox qxym(xmbx, QVAR, amrex::The_Async_Arena());
-  amrex::FArrayBox qxyp(xmbx, QVAR, amrex::The_Async_Arena());
+  amrex::FArrayBox qxym(xmbx, QVAR, pc_scratch_arena());
+  amrex::FArrayBox qxyp(xmbx, QVAR, pc_scratch_arena());
   auto const& qmxy = qxym.array();
   auto const& qpxy = qxyp.array();
 
-  amrex::FArrayBox qxzm(xmbx, QVAR, amrex::The_Async_Arena());
-  amrex::FArrayBox qxzp(xmbx, QVAR, amrex::The_Async_Arena());
+  amrex::FArrayBox qxzm(xmbx, QVAR, pc_scratch_arena());
+  amrex::FArrayBox qxzp(xmbx, QVAR, pc_scratch_arena());
   auto const& qmxz = qxzm.array();
   auto const& qpxz = qxzp.array();
 
@@ -718,10 +841,10 @@ pc_umeth_eb_3D(
   });
 
   const amrex::Box& txfxbx = surroundingNodes(bxg2, cdir);
-  amrex::FArrayBox fluxxy(txfxbx, NVAR, amrex::The_Async_Arena());
-  amrex::FArrayBox fluxxz(txfxbx, NVAR, amrex::The_Async_Arena());
-  amrex::FArrayBox gdvxyfab(txfxbx, NGDNV, amrex::The_Async_Arena());
-  amrex::FArrayBox gdvxzfab(txfxbx, NGDNV, amrex::The_Async_Arena());
+  amrex::FArrayBox fluxxy(txfxbx, NVAR, pc_scratch_arena());
+  amrex::FArrayBox fluxxz(txfxbx, NVAR, pc_scratch_arena());
+  amrex::FArrayBox gdvxyfab(txfxbx, NGDNV, pc_scratch_arena());
+  amrex::FArrayBox gdvxzfab(txfxbx, NGDNV, pc_scratch_arena());
 
   auto const& flxy = fluxxy.array();
   auto const& flxz = fluxxz.array();
@@ -757,13 +880,13 @@ pc_umeth_eb_3D(
   // *************************************************************************************
 
   cdir = 1;
-  amrex::FArrayBox qyxm(ymbx, QVAR, amrex::The_Async_Arena());
-  amrex::FArrayBox qyxp(ymbx, QVAR, amrex::The_Async_Arena());
+  amrex::FArrayBox qyxm(ymbx, QVAR, pc_scratch_arena());
+  amrex::FArrayBox qyxp(ymbx, QVAR, pc_scratch_arena());
   auto const& qmyx = qyxm.array();
   auto const& qpyx = qyxp.array();
 
-  amrex::FArrayBox qyzm(ymbx, QVAR, amrex::The_Async_Arena());
-  amrex::FArrayBox qyzp(ymbx, QVAR, amrex::The_Async_Arena());
+  amrex::FArrayBox qyzm(ymbx, QVAR, pc_scratch_arena());
+  amrex::FArrayBox qyzp(ymbx, QVAR, pc_scratch_arena());
   auto const& qmyz = qyzm.array();
   auto const& qpyz = qyzp.array();
 
@@ -791,10 +914,10 @@ pc_umeth_eb_3D(
 
   // Riemann problem Y|X Y|Z
   const amrex::Box& tyfxbx = surroundingNodes(bxg2, cdir);
-  amrex::FArrayBox fluxyx(tyfxbx, NVAR, amrex::The_Async_Arena());
-  amrex::FArrayBox fluxyz(tyfxbx, NVAR, amrex::The_Async_Arena());
-  amrex::FArrayBox gdvyxfab(tyfxbx, NGDNV, amrex::The_Async_Arena());
-  amrex::FArrayBox gdvyzfab(tyfxbx, NGDNV, amrex::The_Async_Arena());
+  amrex::FArrayBox fluxyx(tyfxbx, NVAR, pc_scratch_arena());
+  amrex::FArrayBox fluxyz(tyfxbx, NVAR, pc_scratch_arena());
+  amrex::FArrayBox gdvyxfab(tyfxbx, NGDNV, pc_scratch_arena());
+  amrex::FArrayBox gdvyzfab(tyfxbx, NGDNV, pc_scratch_arena());
 
   auto const& flyx = fluxyx.array();
   auto const& flyz = fluxyz.array();
@@ -828,13 +951,13 @@ pc_umeth_eb_3D(
   // *************************************************************************************
   cdir = 2;
 
-  amrex::FArrayBox qzxm(zmbx, QVAR, amrex::The_Async_Arena());
-  amrex::FArrayBox qzxp(zmbx, QVAR, amrex::The_Async_Arena());
+  amrex::FArrayBox qzxm(zmbx, QVAR, pc_scratch_arena());
+  amrex::FArrayBox qzxp(zmbx, QVAR, pc_scratch_arena());
   auto const& qmzx = qzxm.array();
   auto const& qpzx = qzxp.array();
 
-  amrex::FArrayBox qzym(zmbx, QVAR, amrex::The_Async_Arena());
-  amrex::FArrayBox qzyp(zmbx, QVAR, amrex::The_Async_Arena());
+  amrex::FArrayBox qzym(zmbx, QVAR, pc_scratch_arena());
+  amrex::FArrayBox qzyp(zmbx, QVAR, pc_scratch_arena());
   auto const& qmzy = qzym.array();
   auto const& qpzy = qzyp.array();
 
@@ -862,10 +985,10 @@ pc_umeth_eb_3D(
 
   // Riemann problem Z|X Z|Y
   const amrex::Box& tzfxbx = surroundingNodes(bxg2, cdir);
-  amrex::FArrayBox fluxzx(tzfxbx, NVAR, amrex::The_Async_Arena());
-  amrex::FArrayBox fluxzy(tzfxbx, NVAR, amrex::The_Async_Arena());
-  amrex::FArrayBox gdvzxfab(tzfxbx, NGDNV, amrex::The_Async_Arena());
-  amrex::FArrayBox gdvzyfab(tzfxbx, NGDNV, amrex::The_Async_Arena());
+  amrex::FArrayBox fluxzx(tzfxbx, NVAR, pc_scratch_arena());
+  amrex::FArrayBox fluxzy(tzfxbx, NVAR, pc_scratch_arena());
+  amrex::FArrayBox gdvzxfab(tzfxbx, NGDNV, pc_scratch_arena());
+  amrex::FArrayBox gdvzyfab(tzfxbx, NGDNV, pc_scratch_arena());
 
   auto const& flzx = fluxzx.array();
   auto const& flzy = fluxzy.array();
@@ -894,8 +1017,8 @@ pc_umeth_eb_3D(
       }
     });
 
-  amrex::FArrayBox qmfab(bxg2, QVAR, amrex::The_Async_Arena());
-  amrex::FArrayBox qpfab(bxg1, QVAR, amrex::The_Async_Arena());
+  amrex::FArrayBox qmfab(bxg2, QVAR, pc_scratch_arena());
+  amrex::FArrayBox qpfab(bxg1, QVAR, pc_scratch_arena());
   auto const& qm = qmfab.array();
   auto const& qp = qpfab.array();
 
@@ -1055,8 +1178,8 @@ pc_umeth_2D(
   int cdir = 0;
   const amrex::Box& xmbx = growHi(bxg2, cdir, 1);
   const amrex::Box& xflxbx = surroundingNodes(grow(bxg2, cdir, -1), cdir);
-  amrex::FArrayBox qxm(xmbx, QVAR, amrex::The_Async_Arena());
-  amrex::FArrayBox qxp(bxg2, QVAR, amrex::The_Async_Arena());
+  amrex::FArrayBox qxm(xmbx, QVAR, pc_scratch_arena());
+  amrex::FArrayBox qxp(bxg2, QVAR, pc_scratch_arena());
   auto const& qxmarr = qxm.array();
   auto const& qxparr = qxp.array();
 
@@ -1064,41 +1187,15 @@ pc_umeth_2D(
   cdir = 1;
   const amrex::Box& ymbx = growHi(bxg2, cdir, 1);
   const amrex::Box& yflxbx = surroundingNodes(grow(bxg2, cdir, -1), cdir);
-  amrex::FArrayBox qym(ymbx, QVAR, amrex::The_Async_Arena());
-  amrex::FArrayBox qyp(bxg2, QVAR, amrex::The_Async_Arena());
+  amrex::FArrayBox qym(ymbx, QVAR, pc_scratch_arena());
+  amrex::FArrayBox qyp(bxg2, QVAR, pc_scratch_arena());
   auto const& qymarr = qym.array();
   auto const& qyparr = qyp.array();
 
   if (ppm_type == 0) {
-    amrex::ParallelFor(
-      bxg2, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
-        amrex::Real slope[QVAR];
-
-        amrex::Real flat = 1.0;
-        // Calculate flattening in-place
-        if (use_flattening) {
-          for (int dir_flat = 0; dir_flat < AMREX_SPACEDIM; dir_flat++) {
-            flat = amrex::min<amrex::Real>(
-              flat, flatten(AMREX_D_DECL(i, j, k), dir_flat, q));
-          }
-        }
-
-        // X slopes and interp
-        for (int n = 0; n < QVAR; ++n)
-          slope[n] =
-            plm_slope(AMREX_D_DECL(i, j, k), n, 0, q, flat, plm_iorder);
-        pc_plm_d(
-          AMREX_D_DECL(i, j, k), 0, qxmarr, qxparr, slope, q, qaux(i, j, k, QC),
-          dx, dt);
-
-        // Y slopes and interp
-        for (int n = 0; n < QVAR; n++)
-          slope[n] =
-            plm_slope(AMREX_D_DECL(i, j, k), n, 1, q, flat, plm_iorder);
-        pc_plm_d(
-          AMREX_D_DECL(i, j, k), 1, qymarr, qyparr, slope, q, qaux(i, j, k, QC),
-          dy, dt);
-      });
+    pc_plm_states(
+      bxg2, q, qaux, {qxmarr, qymarr}, {qxparr, qyparr}, del, dt, plm_iorder,
+      use_flattening);
   } else if (ppm_type == 1) {
     // Compute the normal interface states by reconstructing
     // the primitive variables using the piecewise parabolic method
@@ -1121,33 +1218,25 @@ pc_umeth_2D(
   // These are the first flux estimates as per the corner-transport-upwind
   // method X initial fluxes
   cdir = 0;
-  amrex::FArrayBox fx(xflxbx, NVAR, amrex::The_Async_Arena());
+  amrex::FArrayBox fx(xflxbx, NVAR, pc_scratch_arena());
   auto const& fxarr = fx.array();
-  amrex::FArrayBox qgdx(bxg2, NGDNV, amrex::The_Async_Arena());
+  amrex::FArrayBox qgdx(bxg2, NGDNV, pc_scratch_arena());
   auto const& gdtemp = qgdx.array();
-  amrex::ParallelFor(
-    xflxbx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
-      pc_cmpflx(
-        i, j, k, bclx, bchx, dlx, dhx, qxmarr, qxparr, fxarr, gdtemp, qaux,
-        cdir);
-    });
+  pc_cmpflx_batch(
+    xflxbx, bclx, bchx, dlx, dhx, qxmarr, qxparr, fxarr, gdtemp, qaux, cdir);
 
   // Y initial fluxes
   cdir = 1;
-  amrex::FArrayBox fy(yflxbx, NVAR, amrex::The_Async_Arena());
+  amrex::FArrayBox fy(yflxbx, NVAR, pc_scratch_arena());
   auto const& fyarr = fy.array();
-  amrex::ParallelFor(
-    yflxbx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
-      pc_cmpflx(
-        i, j, k, bcly, bchy, dly, dhy, qymarr, qyparr, fyarr, qec[1], qaux,
-        cdir);
-    });
+  pc_cmpflx_batch(
+    yflxbx, bcly, bchy, dly, dhy, qymarr, qyparr, fyarr, qec[1], qaux, cdir);
 
   // X interface corrections
   cdir = 0;
   const amrex::Box& tybx = grow(bx, cdir, 1);
-  amrex::FArrayBox qm(bxg2, QVAR, amrex::The_Async_Arena());
-  amrex::FArrayBox qp(bxg1, QVAR, amrex::The_Async_Arena());
+  amrex::FArrayBox qm(bxg2, QVAR, pc_scratch_arena());
+  amrex::FArrayBox qp(bxg1, QVAR, pc_scratch_arena());
   auto const& qmarr = qm.array();
   auto const& qparr = qp.array();
 
@@ -1162,10 +1251,8 @@ pc_umeth_2D(
   const amrex::Box& xfxbx = surroundingNodes(bx, cdir);
 
   // Final Riemann problem X
-  amrex::ParallelFor(xfxbx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
-    pc_cmpflx(
-      i, j, k, bclx, bchx, dlx, dhx, qmarr, qparr, flx[0], qec[0], qaux, cdir);
-  });
+  pc_cmpflx_batch(
+    xfxbx, bclx, bchx, dlx, dhx, qmarr, qparr, flx[0], qec[0], qaux, cdir);
 
   // Y interface corrections
   cdir = 1;
@@ -1181,10 +1268,8 @@ pc_umeth_2D(
 
   // Final Riemann problem Y
   const amrex::Box& yfxbx = surroundingNodes(bx, cdir);
-  amrex::ParallelFor(yfxbx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
-    pc_cmpflx(
-      i, j, k, bcly, bchy, dly, dhy, qmarr, qparr, flx[1], qec[1], qaux, cdir);
-  });
+  pc_cmpflx_batch(
+    yfxbx, bcly, bchy, dly, dhy, qmarr, qparr, flx[1], qec[1], qaux, cdir);
 
   // Fix bcnormal boundaries - always use PLM and don't do N+1/2 predictor
   // because the user specifies conditions at N
@@ -1266,8 +1351,8 @@ pc_umeth_eb_2D(
   int cdir = 0;
   const amrex::Box& xmbx = growHi(bxg2, cdir, 1);
   const amrex::Box& xflxbx = surroundingNodes(bxg1, cdir);
-  amrex::FArrayBox qxm(xmbx, QVAR, amrex::The_Async_Arena());
-  amrex::FArrayBox qxp(bxg2, QVAR, amrex::The_Async_Arena());
+  amrex::FArrayBox qxm(xmbx, QVAR, pc_scratch_arena());
+  amrex::FArrayBox qxp(bxg2, QVAR, pc_scratch_arena());
   auto const& qxmarr = qxm.array();
   auto const& qxparr = qxp.array();
 
@@ -1275,8 +1360,8 @@ pc_umeth_eb_2D(
   cdir = 1;
   const amrex::Box& ymbx = growHi(bxg2, cdir, 1);
   const amrex::Box& yflxbx = surroundingNodes(bxg1, cdir);
-  amrex::FArrayBox qym(ymbx, QVAR, amrex::The_Async_Arena());
-  amrex::FArrayBox qyp(bxg2, QVAR, amrex::The_Async_Arena());
+  amrex::FArrayBox qym(ymbx, QVAR, pc_scratch_arena());
+  amrex::FArrayBox qyp(bxg2, QVAR, pc_scratch_arena());
   auto const& qymarr = qym.array();
   auto const& qyparr = qyp.array();
 
@@ -1329,9 +1414,9 @@ pc_umeth_eb_2D(
   // method X initial fluxes
   // *******************************************************************************
   cdir = 0;
-  amrex::FArrayBox fx(xflxbx, NVAR, amrex::The_Async_Arena());
+  amrex::FArrayBox fx(xflxbx, NVAR, pc_scratch_arena());
   auto const& fxarr = fx.array();
-  amrex::FArrayBox qgdx(bxg2, NGDNV, amrex::The_Async_Arena());
+  amrex::FArrayBox qgdx(bxg2, NGDNV, pc_scratch_arena());
   auto const& gdtemp = qgdx.array();
   amrex::ParallelFor(
     xflxbx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
@@ -1347,7 +1432,7 @@ pc_umeth_eb_2D(
   // method Y initial fluxes
   // *******************************************************************************
   cdir = 1;
-  amrex::FArrayBox fy(yflxbx, NVAR, amrex::The_Async_Arena());
+  amrex::FArrayBox fy(yflxbx, NVAR, pc_scratch_arena());
   auto const& fyarr = fy.array();
   amrex::ParallelFor(
     yflxbx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
@@ -1363,8 +1448,8 @@ pc_umeth_eb_2D(
   // *******************************************************************************
   cdir = 0;
   const amrex::Box& tybx = bxg1;
-  amrex::FArrayBox qm(bxg2, QVAR, amrex::The_Async_Arena());
-  amrex::FArrayBox qp(bxg1, QVAR, amrex::The_Async_Arena());
+  amrex::FArrayBox qm(bxg2, QVAR, pc_scratch_arena());
+  amrex::FArrayBox qp(bxg1, QVAR, pc_scratch_arena());
   auto const& qmarr = qm.array();
   auto const& qparr = qp.array();
 
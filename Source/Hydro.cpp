@@ -1,4 +1,5 @@
 #include "Hydro.H"
+#include "ScratchArena.H"
 
 // Set up the source terms to go into the hydro.
 void
@@ -56,6 +57,7 @@ PeleC::construct_hydro_source(
     auto const& fact =
       dynamic_cast<amrex::EBFArrayBoxFactory const&>(S.Factory());
     auto const& flags = fact.getMultiEBCellFlagFab();
+    const bool use_cache = prim_cached(S, numGrow() + nGrowF);
 
 #ifdef AMREX_USE_OMP
 #pragma omp parallel if (amrex::Gpu::notInLaunchRegion())          \
@@ -67,6 +69,7 @@ PeleC::construct_hydro_source(
 #endif
     {
       amrex::Real cflLoc = std::numeric_limits<amrex::Real>::lowest();
+      amrex::Arena* scratch = pc_scratch_arena();
 
       const int* domain_lo = geom.Domain().loVect();
       const int* domain_hi = geom.Domain().hiVect();
@@ -88,24 +91,36 @@ PeleC::construct_hydro_source(
         amrex::GpuArray<amrex::FArrayBox, AMREX_SPACEDIM> flux;
         for (int dir = 0; dir < AMREX_SPACEDIM; ++dir) {
           const amrex::Box& efbx = surroundingNodes(fbx, dir);
-          flux[dir].resize(efbx, NVAR, amrex::The_Async_Arena());
+          flux[dir].resize(efbx, NVAR, scratch);
           flux[dir].setVal<amrex::RunOn::Device>(0.0);
         }
 
         auto const& sarr = S.array(mfi);
         auto const& hyd_src = hydro_source.array(mfi);
 
-        // Temporary Fabs
-        amrex::FArrayBox q(qbx, QVAR, amrex::The_Async_Arena());
-        amrex::FArrayBox qaux(qbx, NQAUX, amrex::The_Async_Arena());
-        amrex::FArrayBox src_q(qbx, QVAR, amrex::The_Async_Arena());
+        // Temporary Fabs. The primitives are read from the cache of this
+        // fill of S (prim_cache) on tiles without covered cells, and
+        // computed here with the covered cells zeroed otherwise.
+        const bool cached =
+          use_cache && (flag_fab.getType(qbx) == amrex::FabType::regular);
+        amrex::FArrayBox q;
+        amrex::FArrayBox qaux;
+        if (cached) {
+          q = amrex::FArrayBox(prim_q[mfi], amrex::make_alias, 0, QVAR);
+          qaux = amrex::FArrayBox(
+            prim_qaux[mfi], amrex::make_alias, 0, prim_qaux.nComp());
+        } else {
+          q.resize(qbx, QVAR, scratch);
+          qaux.resize(qbx, NQAUX, scratch);
+        }
+        amrex::FArrayBox src_q(qbx, QVAR, scratch);
 
         // Get Arrays to pass to the gpu.
         auto const& qarr = q.array();
         auto const& qauxar = qaux.array();
         auto const& srcqarr = src_q.array();
 
-        {
+        if (!cached) {
           BL_PROFILE("PeleC::ctoprim()");
           amrex::ParallelFor(
             qbx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
@@ -298,7 +313,9 @@ PeleC::construct_hydro_source(
     if (courno > 1.0) {
       amrex::Print() << "WARNING -- EFFECTIVE CFL AT THIS LEVEL " << level
                      << " IS " << courno << '\n';
-      if (hard_cfl_limit) {
+      if (hard_cfl_limit && (step_retries > 0)) {
+        step_failed = true;
+      } else if (hard_cfl_limit) {
         amrex::Abort("CFL is too high at this level -- go back to a checkpoint "
                      "and restart with lower cfl number");
       }
@@ -339,14 +356,14 @@ pc_umdrv(
   amrex::FArrayBox qec[AMREX_SPACEDIM];
   for (int dir = 0; dir < AMREX_SPACEDIM; dir++) {
     const amrex::Box eboxes = amrex::surroundingNodes(bxg2, dir);
-    qec[dir].resize(eboxes, NGDNV, amrex::The_Async_Arena());
+    qec[dir].resize(eboxes, NGDNV, pc_scratch_arena());
   }
   amrex::GpuArray<const amrex::Array4<amrex::Real>, AMREX_SPACEDIM> qec_arr{
     {AMREX_D_DECL(qec[0].array(), qec[1].array(), qec[2].array())}};
 
   // Temporary FArrayBoxes
-  amrex::FArrayBox divu(bxg2, 1, amrex::The_Async_Arena());
-  amrex::FArrayBox pdivu(bx, 1, amrex::The_Async_Arena());
+  amrex::FArrayBox divu(bxg2, 1, pc_scratch_arena());
+  amrex::FArrayBox pdivu(bx, 1, pc_scratch_arena());
   auto const& divuarr = divu.array();
   auto const& pdivuarr = pdivu.array();
 
@@ -0,0 +1,398 @@
+#include <AMReX_MLABecLaplacian.H>
+#include <AMReX_MLMG.H>
+
+#include "PeleC.H"
+#include "IMEX.H"
+
+namespace {
+// Pressure boundary of a domain side: Dirichlet (the pressure of the filled
+// state) at outflows and Neumann (no normal pressure gradient) elsewhere
+amrex::LinOpBCType
+imex_pressure_bc(
+  const amrex::Geometry& geom,
+  const amrex::BCRec& bc,
+  const int dir,
+  const bool lo)
+{
+  if (geom.isPeriodic(dir)) {
+    return amrex::LinOpBCType::Periodic;
+  }
+  const int type = lo ? bc.lo(dir) : bc.hi(dir);
+  return (type == PCPhysBCType::outflow) ? amrex::LinOpBCType::Dirichlet
+                                         : amrex::LinOpBCType::Neumann;
+}
+} // namespace
+
+void
+PeleC::do_imex_advance(
+  amrex::Real time,
+  amrex::Real dt,
+  int amr_iteration,
+  int amr_ncycle,
+  amrex::MultiFab& molSrc,
+  int nGrow_FP_border)
+{
+  // Low Mach implicit-explicit advance (imex_acoustic), first order in time:
+  //   U* = U^n + dt*(-div(u U) + D + sources + I_R)
+  //   p* = p^n - dt*(div(p u) - p div(u))
+  //   p^{n+1} - rho c^2 dt^2 div(grad(p^{n+1})/rho) = p* - rho c^2 dt div(u*)
+  //   U^{n+1} = U* - dt*div(0, p^{n+1}, p^{n+1} u^{n+1})
+  // The sound waves are only carried by the implicit pressure solve, so the
+  // time step is limited by the convective CFL. The reactions follow as in
+  // the RK advance, with the reaction source of the previous step lagged in
+  // the transport step.
+  BL_PROFILE("PeleC::do_imex_advance()");
+
+  if (eb_in_domain) {
+    amrex::Abort("pelec.imex_acoustic does not support embedded boundaries");
+  }
+
+  amrex::MultiFab& S_old = get_old_data(State_Type);
+  amrex::MultiFab& S_new = get_new_data(State_Type);
+  const amrex::MultiFab& I_R = get_new_data(Reactions_Type);
+
+  if (verbose != 0) {
+    amrex::Print() << "... Computing explicit IMEX terms" << std::endl;
+  }
+  fill_stage_state(Sborder, nGrow_FP_border, time);
+  getMOLSrcTerm(Sborder, molSrc, time, dt, 1.0, MOLTerms::Diffusion);
+  amrex::MultiFab p_star(grids, dmap, 1, 0);
+  amrex::MultiFab acoef(grids, dmap, 1, 0);
+  imex_explicit_terms(Sborder, molSrc, p_star, acoef, dt);
+
+  amrex::Vector<const amrex::MultiFab*> srcs;
+  for (int src : src_list) {
+    if (src != diff_src) {
+      construct_old_source(src, time, dt, amr_iteration, amr_ncycle, 0, 0);
+      srcs.push_back(old_sources[src].get());
+    }
+  }
+  mol_stage_update(
+    S_new, 1.0, S_old, 0.0, S_old, dt, molSrc, srcs, dt, I_R, dt, false, true);
+
+  if (verbose != 0) {
+    amrex::Print() << "... Solving for the IMEX pressure" << std::endl;
+  }
+  // The implicit operator uses rho c^2 of time n (acoef), linearized about
+  // the known state, while its right-hand side and 1/rho use the predicted
+  // state U*, held by S_new and filled at time + dt, as that is the state the
+  // pressure correction is applied to
+  FillPatcherFill(Sborder, 0, NVAR, nGrow_FP_border, time + dt, State_Type, 0);
+  amrex::MultiFab p_new;
+  amrex::Array<amrex::MultiFab, AMREX_SPACEDIM> uface;
+  imex_pressure_solve(Sborder, p_star, acoef, time + dt, dt, p_new, uface);
+  imex_pressure_update(p_new, uface, dt);
+  computeTemp(S_new, 0);
+
+  if (do_react) {
+    const amrex::Vector<const amrex::MultiFab*> no_srcs;
+    mol_stage_update(
+      S_new, 1.0, S_new, 0.0, S_old, 0.0, molSrc, no_srcs, 0.0, I_R, dt, true,
+      false);
+    react_state(time, dt, false, &molSrc);
+
+    computeTemp(S_new, 0);
+  }
+}
+
+void
+PeleC::imex_explicit_terms(
+  const amrex::MultiFab& S,
+  amrex::MultiFab& src,
+  amrex::MultiFab& p_star,
+  amrex::MultiFab& acoef,
+  amrex::Real dt)
+{
+  // Add the advective terms -div(u U) of S to src, and compute the advected
+  // pressure p* and the coefficient 1/(rho c^2 dt^2) of the pressure solve
+  BL_PROFILE("PeleC::imex_explicit_terms()");
+  AMREX_ASSERT(S.nGrow() >= 2);
+
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
+#endif
+  for (amrex::MFIter mfi(src, amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi) {
+    const amrex::Box& bx = mfi.tilebox();
+    const amrex::Box gbx = amrex::grow(bx, 2);
+    auto const& s = S.const_array(mfi);
+
+    amrex::FArrayBox pfab(gbx, 1, amrex::The_Async_Arena());
+    auto const& pw = pfab.array();
+    amrex::ParallelFor(
+      gbx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
+        pw(i, j, k) = pc_imex_pressure(i, j, k, s);
+      });
+    auto const& p = pfab.const_array();
+
+    amrex::FArrayBox flux[AMREX_SPACEDIM];
+    amrex::FArrayBox pflux[AMREX_SPACEDIM];
+    amrex::GpuArray<amrex::Array4<const amrex::Real>, AMREX_SPACEDIM> flx;
+    amrex::GpuArray<amrex::Array4<const amrex::Real>, AMREX_SPACEDIM> pfl;
+    for (int dir = 0; dir < AMREX_SPACEDIM; dir++) {
+      const amrex::Box ebx = amrex::surroundingNodes(bx, dir);
+      flux[dir].resize(ebx, NVAR, amrex::The_Async_Arena());
+      pflux[dir].resize(ebx, 2, amrex::The_Async_Arena());
+      auto const& f = flux[dir].array();
+      auto const& pf = pflux[dir].array();
+      auto const& a = area[dir].const_array(mfi);
+      amrex::ParallelFor(
+        ebx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
+          pc_imex_adv_flux(i, j, k, dir, s, p, a, f, pf);
+        });
+      flx[dir] = flux[dir].const_array();
+      pfl[dir] = pflux[dir].const_array();
+    }
+
+    auto const& vol = volume.const_array(mfi);
+    auto const& L = src.array(mfi);
+    auto const& ps = p_star.array(mfi);
+    auto const& ac = acoef.array(mfi);
+    amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
+      const amrex::IntVect iv(AMREX_D_DECL(i, j, k));
+      const amrex::Real volinv = 1.0 / vol(iv);
+      amrex::Real divpu = 0.0;
+      amrex::Real divu = 0.0;
+      for (int dir = 0; dir < AMREX_SPACEDIM; dir++) {
+        const amrex::IntVect ivp = iv + amrex::IntVect::TheDimensionVector(dir);
+        for (int n = 0; n < NVAR; n++) {
+          L(iv, n) -= (flx[dir](ivp, n) - flx[dir](iv, n)) * volinv;
+        }
+        divpu += (pfl[dir](ivp, 0) - pfl[dir](iv, 0)) * volinv;
+        divu += (pfl[dir](ivp, 1) - pfl[dir](iv, 1)) * volinv;
+      }
+      ps(iv) = p(iv) - dt * (divpu - p(iv) * divu);
+      // rho c^2 is frozen at time n, which keeps the pressure solve linear
+      ac(iv) = pc_imex_acoef(i, j, k, s, dt);
+    });
+
+    if (do_reflux) {
+      amrex::FArrayBox dm_as_fine(
+        amrex::Box::TheUnitBox(), NVAR, amrex::The_Async_Arena());
+      update_flux_registers(
+        dt, mfi, amrex::FabType::regular,
+        {AMREX_D_DECL(&flux[0], &flux[1], &flux[2])}, dm_as_fine);
+    }
+  }
+}
+
+void
+PeleC::imex_pressure_solve(
+  const amrex::MultiFab& S,
+  const amrex::MultiFab& p_star,
+  const amrex::MultiFab& acoef,
+  amrex::Real time,
+  amrex::Real dt,
+  amrex::MultiFab& p,
+  amrex::Array<amrex::MultiFab, AMREX_SPACEDIM>& uface)
+{
+  // Solve a p - div(b grad(p)) = a p* - div(u*)/dt for the end of step
+  // pressure p, with a = 1/(rho c^2 dt^2) and b = 1/rho, where S holds U*
+  // and its ghost cells at time. On return, the ghost cells of p hold the
+  // pressure of S on the domain and coarse-fine boundaries and uface the end
+  // of step face velocities u* - dt grad(p)/rho.
+  BL_PROFILE("PeleC::imex_pressure_solve()");
+
+  const auto dxinv = geom.InvCellSizeArray();
+  amrex::MultiFab rhs(grids, dmap, 1, 0);
+  amrex::Array<amrex::MultiFab, AMREX_SPACEDIM> bcoef;
+  p.define(grids, dmap, 1, 1);
+  for (int dir = 0; dir < AMREX_SPACEDIM; dir++) {
+    const amrex::BoxArray fba =
+      amrex::convert(grids, amrex::IntVect::TheDimensionVector(dir));
+    bcoef[dir].define(fba, dmap, 1, 0);
+    uface[dir].define(fba, dmap, 1, 0);
+  }
+
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
+#endif
+  for (amrex::MFIter mfi(rhs, amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi) {
+    const amrex::Box& bx = mfi.tilebox();
+    auto const& s = S.const_array(mfi);
+
+    amrex::GpuArray<amrex::Array4<const amrex::Real>, AMREX_SPACEDIM> uf;
+    for (int dir = 0; dir < AMREX_SPACEDIM; dir++) {
+      auto const& b = bcoef[dir].array(mfi);
+      auto const& u = uface[dir].array(mfi);
+      amrex::ParallelFor(
+        mfi.nodaltilebox(dir),
+        [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
+          const amrex::IntVect iv(AMREX_D_DECL(i, j, k));
+          const amrex::IntVect ivm =
+            iv - amrex::IntVect::TheDimensionVector(dir);
+          b(iv) = 2.0 / (s(ivm, URHO) + s(iv, URHO));
+          u(iv) = pc_imex_face_vel(iv, dir, s);
+        });
+      uf[dir] = uface[dir].const_array(mfi);
+    }
+
+    auto const& pb = p.array(mfi);
+    amrex::ParallelFor(
+      mfi.growntilebox(1), [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
+        pb(i, j, k) = pc_imex_pressure(i, j, k, s);
+      });
+
+    auto const& ps = p_star.const_array(mfi);
+    auto const& ac = acoef.const_array(mfi);
+    auto const& r = rhs.array(mfi);
+    amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
+      const amrex::IntVect iv(AMREX_D_DECL(i, j, k));
+      amrex::Real divu = 0.0;
+      for (int dir = 0; dir < AMREX_SPACEDIM; dir++) {
+        const amrex::IntVect ivp = iv + amrex::IntVect::TheDimensionVector(dir);
+        divu += (uf[dir](ivp) - uf[dir](iv)) * dxinv[dir];
+      }
+      r(iv) = ac(iv) * ps(iv) - divu / dt;
+    });
+  }
+
+  amrex::Array<amrex::LinOpBCType, AMREX_SPACEDIM> lobc;
+  amrex::Array<amrex::LinOpBCType, AMREX_SPACEDIM> hibc;
+  for (int dir = 0; dir < AMREX_SPACEDIM; dir++) {
+    lobc[dir] = imex_pressure_bc(geom, phys_bc, dir, true);
+    hibc[dir] = imex_pressure_bc(geom, phys_bc, dir, false);
+  }
+
+  amrex::LPInfo info;
+  amrex::MLABecLaplacian mlabec({geom}, {grids}, {dmap}, info);
+  mlabec.setMaxOrder(2);
+  mlabec.setDomainBC(lobc, hibc);
+
+  // Coarse pressure at the end of the step for the coarse-fine boundary
+  amrex::MultiFab p_crse;
+  if (level > 0) {
+    PeleC& crse = getLevel(level - 1);
+    amrex::MultiFab S_crse(
+      crse.boxArray(), crse.DistributionMap(), NVAR, 0, amrex::MFInfo(),
+      crse.Factory());
+    FillPatch(crse, S_crse, 0, time, State_Type, 0, NVAR);
+    p_crse.define(crse.boxArray(), crse.DistributionMap(), 1, 0);
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
+#endif
+    for (amrex::MFIter mfi(p_crse, amrex::TilingIfNotGPU()); mfi.isValid();
+         ++mfi) {
+      auto const& s = S_crse.const_array(mfi);
+      auto const& pc = p_crse.array(mfi);
+      amrex::ParallelFor(
+        mfi.tilebox(), [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
+          pc(i, j, k) = pc_imex_pressure(i, j, k, s);
+        });
+    }
+    mlabec.setCoarseFineBC(&p_crse, parent->refRatio(level - 1)[0]);
+  }
+
+  mlabec.setLevelBC(0, &p);
+  mlabec.setScalars(1.0, 1.0);
+  mlabec.setACoeffs(0, acoef);
+  mlabec.setBCoeffs(0, amrex::GetArrOfConstPtrs(bcoef));
+
+  amrex::MLMG mlmg(mlabec);
+  mlmg.setVerbose(verbose > 1 ? 1 : 0);
+  amrex::MultiFab phi(grids, dmap, 1, 1);
+  amrex::MultiFab::Copy(phi, p, 0, 0, 1, 1);
+  mlmg.solve({&phi}, {&rhs}, imex_rtol, imex_atol);
+
+  // The solver fluxes are -b grad(p)
+  amrex::Array<amrex::MultiFab, AMREX_SPACEDIM> gp;
+  for (int dir = 0; dir < AMREX_SPACEDIM; dir++) {
+    gp[dir].define(bcoef[dir].boxArray(), dmap, 1, 0);
+  }
+  mlmg.getFluxes({amrex::GetArrOfPtrs(gp)});
+  for (int dir = 0; dir < AMREX_SPACEDIM; dir++) {
+    amrex::MultiFab::Saxpy(uface[dir], dt, gp[dir], 0, 0, 1, 0);
+  }
+
+  amrex::MultiFab::Copy(p, phi, 0, 0, 1, 0);
+  p.FillBoundary(geom.periodicity());
+}
+
+void
+PeleC::imex_pressure_update(
+  const amrex::MultiFab& p,
+  const amrex::Array<amrex::MultiFab, AMREX_SPACEDIM>& uface,
+  amrex::Real dt)
+{
+  // U -= dt*div(0, p, p u) with the end of step pressure and face velocities.
+  // The face pressure is the interior one on Neumann boundaries and the
+  // ghost cell (face) value on Dirichlet boundaries.
+  BL_PROFILE("PeleC::imex_pressure_update()");
+
+  amrex::MultiFab& S_new = get_new_data(State_Type);
+  const amrex::Box& domain = geom.Domain();
+
+  // Face pressure on the low and high domain faces: 0 for the average of
+  // the two sides, 1 for the interior value and 2 for the ghost value
+  amrex::GpuArray<int, AMREX_SPACEDIM> lo_side;
+  amrex::GpuArray<int, AMREX_SPACEDIM> hi_side;
+  for (int dir = 0; dir < AMREX_SPACEDIM; dir++) {
+    const amrex::LinOpBCType lo = imex_pressure_bc(geom, phys_bc, dir, true);
+    const amrex::LinOpBCType hi = imex_pressure_bc(geom, phys_bc, dir, false);
+    lo_side[dir] = (lo == amrex::LinOpBCType::Neumann) ? 1 : 2;
+    hi_side[dir] = (hi == amrex::LinOpBCType::Neumann) ? 1 : 2;
+    if (geom.isPeriodic(dir)) {
+      lo_side[dir] = 0;
+      hi_side[dir] = 0;
+    }
+  }
+
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
+#endif
+  for (amrex::MFIter mfi(S_new, amrex::TilingIfNotGPU()); mfi.isValid();
+       ++mfi) {
+    const amrex::Box& bx = mfi.tilebox();
+    auto const& pa = p.const_array(mfi);
+
+    amrex::FArrayBox flux[AMREX_SPACEDIM];
+    amrex::GpuArray<amrex::Array4<const amrex::Real>, AMREX_SPACEDIM> flx;
+    for (int dir = 0; dir < AMREX_SPACEDIM; dir++) {
+      const amrex::Box ebx = amrex::surroundingNodes(bx, dir);
+      flux[dir].resize(ebx, NVAR, amrex::The_Async_Arena());
+      auto const& f = flux[dir].array();
+      setV(ebx, NVAR, f, 0.0);
+      auto const& a = area[dir].const_array(mfi);
+      auto const& u = uface[dir].const_array(mfi);
+      const int dlo = domain.smallEnd(dir);
+      const int dhi = domain.bigEnd(dir) + 1;
+      const int lside = lo_side[dir];
+      const int hside = hi_side[dir];
+      amrex::ParallelFor(
+        ebx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
+          const amrex::IntVect iv(AMREX_D_DECL(i, j, k));
+          const amrex::IntVect ivm =
+            iv - amrex::IntVect::TheDimensionVector(dir);
+          amrex::Real pf = 0.5 * (pa(ivm) + pa(iv));
+          if ((iv[dir] == dlo) && (lside > 0)) {
+            pf = (lside == 1) ? pa(iv) : pa(ivm);
+          } else if ((iv[dir] == dhi) && (hside > 0)) {
+            pf = (hside == 1) ? pa(ivm) : pa(iv);
+          }
+          f(iv, UMX + dir) = pf * a(iv);
+          f(iv, UEDEN) = pf * u(iv) * a(iv);
+        });
+      flx[dir] = flux[dir].const_array();
+    }
+
+    auto const& vol = volume.const_array(mfi);
+    auto const& s = S_new.array(mfi);
+    amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
+      const amrex::IntVect iv(AMREX_D_DECL(i, j, k));
+      const amrex::Real fac = dt / vol(iv);
+      for (int dir = 0; dir < AMREX_SPACEDIM; dir++) {
+        const amrex::IntVect ivp = iv + amrex::IntVect::TheDimensionVector(dir);
+        s(iv, UMX + dir) -=
+          fac * (flx[dir](ivp, UMX + dir) - flx[dir](iv, UMX + dir));
+        s(iv, UEDEN) -= fac * (flx[dir](ivp, UEDEN) - flx[dir](iv, UEDEN));
+      }
+    });
+
+    if (do_reflux) {
+      amrex::FArrayBox dm_as_fine(
+        amrex::Box::TheUnitBox(), NVAR, amrex::The_Async_Arena());
+      update_flux_registers(
+        dt, mfi, amrex::FabType::regular,
+        {AMREX_D_DECL(&flux[0], &flux[1], &flux[2])}, dm_as_fine);
+    }
+  }
+}
@@ -219,6 +219,8 @@ PeleC::set_state_in_checkpoint(amrex::Vector<int>& state_in_checkpoint)
         amrex::Abort("State_Type is not present in the checkpoint file");
       }
     } else if (i == Reactions_Type) {
+      // Its number of components depends on chem_telemetry, which must
+      // match the run that wrote the checkpoint
       if (!do_react) {
         state_in_checkpoint[i] = 0;
       } else {
@@ -355,7 +357,7 @@ PeleC::setPlotVariables()
   int plot_reactions = 1;
   pp.query("plot_reactions", plot_reactions);
   if (plot_reactions == 0) {
-    for (int i = 0; i < NUM_SPECIES + 2; i++) {
+    for (int i = 0; i < desc_lst[Reactions_Type].nComp(); i++) {
       amrex::Amr::deleteStatePlotVar(desc_lst[Reactions_Type].name(i));
     }
   }
@@ -162,18 +162,24 @@ PeleC::getSmagorinskyLESTerm(
   const int ngrow = 1;
   const amrex::GpuArray<amrex::Real, AMREX_SPACEDIM> dx = geom.CellSizeArray();
 
-  amrex::MultiFab S(grids, dmap, NVAR, ngrow, amrex::MFInfo(), Factory());
-  FillPatch(*this, S, ngrow, time, State_Type, 0, NVAR);
+  // The primitives of the state at time are read from the cache of the
+  // stage (prim_cache) when it holds them, without filling the state again
+  const bool use_cache = prim_cached_at(time, ngrow);
+  amrex::MultiFab S;
+  if (!use_cache) {
+    S.define(grids, dmap, NVAR, ngrow, amrex::MFInfo(), Factory());
+    FillPatch(*this, S, ngrow, time, State_Type, 0, NVAR);
+  }
 
-  auto const& fact =
-    dynamic_cast<amrex::EBFArrayBoxFactory const&>(S.Factory());
+  auto const& fact = dynamic_cast<amrex::EBFArrayBoxFactory const&>(Factory());
   auto const& flags = fact.getMultiEBCellFlagFab();
 
 #ifdef AMREX_USE_OMP
 #pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
 #endif
   {
-    for (amrex::MFIter mfi(S, amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi) {
+    for (amrex::MFIter mfi(LESTerm, amrex::TilingIfNotGPU()); mfi.isValid();
+         ++mfi) {
       const amrex::Box vbox = mfi.tilebox();
       const amrex::Box gbox = amrex::grow(vbox, ngrow);
       const amrex::Box cbox = amrex::grow(vbox, ngrow - 1);
@@ -187,16 +193,23 @@ PeleC::getSmagorinskyLESTerm(
         continue;
       }
 
-      auto const& s = S.array(mfi);
       int nqaux = NQAUX > 0 ? NQAUX : 1;
-      amrex::FArrayBox q(gbox, QVAR, amrex::The_Async_Arena());
-      amrex::FArrayBox qaux(gbox, nqaux, amrex::The_Async_Arena());
+      amrex::FArrayBox q;
+      amrex::FArrayBox qaux;
+      if (use_cache) {
+        q = amrex::FArrayBox(prim_q[mfi], amrex::make_alias, 0, QVAR);
+        qaux = amrex::FArrayBox(prim_qaux[mfi], amrex::make_alias, 0, nqaux);
+      } else {
+        q.resize(gbox, QVAR, amrex::The_Async_Arena());
+        qaux.resize(gbox, nqaux, amrex::The_Async_Arena());
+      }
       auto const& q_ar = q.array();
       auto const& qauxar = qaux.array();
 
       // Get primitives, Q, including (Y, T, p, rho) from conserved state
       // required for L term
-      {
+      if (!use_cache) {
+        auto const& s = S.array(mfi);
         BL_PROFILE("PeleC::ctoprim()");
         amrex::ParallelFor(
           gbox, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
@@ -1,206 +1,284 @@
 #include "MOL.H"
 #include "Godunov.H"
 #include "prob.H"
+#include "ScratchArena.H"
 
+namespace {
+// Fluxes of the faces of ebox for pc_compute_hyp_mol_flux, specialized on
+// the Riemann solver
+template <bool UseLaxF>
 void
-pc_compute_hyp_mol_flux(
-  const amrex::Box& cbox,
+pc_mol_face_fluxes(
+  const amrex::Box& ebox,
+  const int dir,
+  const amrex::GpuArray<const int, 3>& q_idx,
+  const amrex::GpuArray<const int, 3>& f_idx,
   const amrex::Array4<const amrex::Real>& q,
   const amrex::Array4<const amrex::Real>& qaux,
-  const amrex::GpuArray<amrex::Array4<amrex::Real>, AMREX_SPACEDIM>& flx,
-  const amrex::GpuArray<const amrex::Array4<const amrex::Real>, AMREX_SPACEDIM>&
-    area,
-  const int mol_iorder,
-  const bool use_laxf_flux,
-  const amrex::Array4<amrex::EBCellFlag const>& flags)
+  const amrex::Array4<const amrex::Real>& dq,
+  const amrex::Array4<amrex::Real>& flx,
+  const amrex::Array4<const amrex::Real>& area)
 {
-  const int R_RHO = 0;
-  const int R_UN = 1;
-  const int R_UT1 = 2;
-  const int R_UT2 = 3;
-  const int R_P = 4;
-  const int R_ADV = 5;
-  const int R_Y = R_ADV + NUM_ADV;
-  const int R_NUM = 5 + NUM_SPECIES + NUM_ADV + NUM_LIN + NUM_AUX;
+  using namespace MOLFace;
   const int bc_test_val = 1;
 
-  for (int dir = 0; dir < AMREX_SPACEDIM; dir++) {
-    amrex::FArrayBox dq_fab(cbox, QVAR, amrex::The_Async_Arena());
-    auto const& dq = dq_fab.array();
-    setV(cbox, QVAR, dq, 0.0);
+  amrex::ParallelFor(ebox, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
+    const amrex::IntVect iv{AMREX_D_DECL(i, j, k)};
+    const amrex::IntVect ivm(iv - amrex::IntVect::TheDimensionVector(dir));
 
-    // dimensional indexing
-    const amrex::GpuArray<const int, 3> bdim{
-      {static_cast<int>(dir == 0), static_cast<int>(dir == 1),
-       static_cast<int>(dir == 2)}};
-    const amrex::GpuArray<const int, 3> q_idx{
-      {bdim[0] * QU + bdim[1] * QV + bdim[2] * QW,
-       bdim[0] * QV + bdim[1] * QU + bdim[2] * QU,
-       bdim[0] * QW + bdim[1] * QW + bdim[2] * QV}};
-    const amrex::GpuArray<const int, 3> f_idx{
-      {bdim[0] * UMX + bdim[1] * UMY + bdim[2] * UMZ,
-       bdim[0] * UMY + bdim[1] * UMX + bdim[2] * UMX,
-       bdim[0] * UMZ + bdim[1] * UMZ + bdim[2] * UMY}};
+    amrex::Real qtempl[R_NUM] = {0.0};
+    amrex::Real qtempr[R_NUM] = {0.0};
+    mol_face_states(iv, ivm, q_idx, q, qaux, dq, qtempl, qtempr);
 
-    if (mol_iorder != 1) {
-      amrex::ParallelFor(
-        cbox, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
-          mol_slope(i, j, k, dir, q_idx, q, qaux, dq, flags);
-        });
+    const amrex::Real cavg = 0.5 * (qaux(iv, QC) + qaux(ivm, QC));
+
+    amrex::Real spl[NUM_SPECIES];
+    for (int n = 0; n < NUM_SPECIES; n++) {
+      spl[n] = qtempl[R_Y + n];
     }
-    const amrex::Box tbox = amrex::grow(cbox, dir, -1);
-    const amrex::Box ebox = amrex::surroundingNodes(tbox, dir);
-    amrex::ParallelFor(
-      ebox, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
-        const amrex::IntVect iv{AMREX_D_DECL(i, j, k)};
-        const amrex::IntVect ivm(iv - amrex::IntVect::TheDimensionVector(dir));
-
-        amrex::Real qtempl[R_NUM] = {0.0};
-        qtempl[R_UN] =
-          q(ivm, q_idx[0]) + 0.5 * ((dq(ivm, 1) - dq(ivm, 0)) / q(ivm, QRHO));
-        qtempl[R_P] =
-          q(ivm, QPRES) + 0.5 * (dq(ivm, 0) + dq(ivm, 1)) * qaux(ivm, QC);
-        qtempl[R_UT1] = q(ivm, q_idx[1]) + 0.5 * dq(ivm, 2);
-        qtempl[R_UT2] =
-          AMREX_D_PICK(0.0, 0.0, q(ivm, q_idx[2]) + 0.5 * dq(ivm, 3));
-        qtempl[R_RHO] = 0.0;
-        for (int n = 0; n < NUM_SPECIES; n++) {
-          qtempl[R_Y + n] =
-            q(ivm, QFS + n) * q(ivm, QRHO) +
-            0.5 * (dq(ivm, QFS + n) +
-                   q(ivm, QFS + n) * (dq(ivm, 0) + dq(ivm, 1)) / qaux(ivm, QC));
-          qtempl[R_RHO] += qtempl[R_Y + n];
-        }
 
-        for (int n = 0; n < NUM_SPECIES; n++) {
-          qtempl[R_Y + n] = qtempl[R_Y + n] / qtempl[R_RHO];
-        }
+    amrex::Real spr[NUM_SPECIES];
+    for (int n = 0; n < NUM_SPECIES; n++) {
+      spr[n] = qtempr[R_Y + n];
+    }
 
-        amrex::Real qtempr[R_NUM] = {0.0};
-        qtempr[R_UN] =
-          q(iv, q_idx[0]) - 0.5 * ((dq(iv, 1) - dq(iv, 0)) / q(iv, QRHO));
-        qtempr[R_P] =
-          q(iv, QPRES) - 0.5 * (dq(iv, 0) + dq(iv, 1)) * qaux(iv, QC);
-        qtempr[R_UT1] = q(iv, q_idx[1]) - 0.5 * dq(iv, 2);
-        qtempr[R_UT2] =
-          AMREX_D_PICK(0.0, 0.0, q(iv, q_idx[2]) - 0.5 * dq(iv, 3));
-        qtempr[R_RHO] = 0.0;
-        for (int n = 0; n < NUM_SPECIES; n++) {
-          qtempr[R_Y + n] =
-            q(iv, QFS + n) * q(iv, QRHO) -
-            0.5 * (dq(iv, QFS + n) +
-                   q(iv, QFS + n) * (dq(iv, 0) + dq(iv, 1)) / qaux(iv, QC));
-          qtempr[R_RHO] += qtempr[R_Y + n];
-        }
-        for (int n = 0; n < NUM_SPECIES; n++) {
-          qtempr[R_Y + n] = qtempr[R_Y + n] / qtempr[R_RHO];
-        }
+    amrex::Real flux_tmp[NVAR] = {0.0};
+    amrex::Real ustar = 0.0;
 
+    if constexpr (!UseLaxF) {
+      amrex::Real qint_iu = 0.0, tmp1 = 0.0, tmp2 = 0.0, tmp3 = 0.0,
+                  tmp4 = 0.0;
+      riemann(
+        qtempl[R_RHO], qtempl[R_UN], qtempl[R_UT1], qtempl[R_UT2],
+        qtempl[R_P], spl, qtempr[R_RHO], qtempr[R_UN], qtempr[R_UT1],
+        qtempr[R_UT2], qtempr[R_P], spr, bc_test_val, cavg, ustar,
+        flux_tmp[URHO], &flux_tmp[UFS], flux_tmp[f_idx[0]],
+        flux_tmp[f_idx[1]], flux_tmp[f_idx[2]], flux_tmp[UEDEN],
+        flux_tmp[UEINT], qint_iu, tmp1, tmp2, tmp3, tmp4);
 #if NUM_ADV > 0
-        for (int n = 0; n < NUM_ADV; n++) {
-          qtempl[R_ADV + n] = q(ivm, QFA + n) + 0.5 * dq(ivm, QFA + n);
-          qtempr[R_ADV + n] = q(iv, QFA + n) - 0.5 * dq(iv, QFA + n);
-        }
+      for (int n = 0; n < NUM_ADV; n++) {
+        pc_cmpflx_passive(
+          ustar, flux_tmp[URHO], qtempl[R_ADV + n], qtempr[R_ADV + n],
+          flux_tmp[UFA + n]);
+      }
 #endif
 #if NUM_AUX > 0
-        const int R_AUX = R_Y + NUM_SPECIES;
-        for (int n = 0; n < NUM_AUX; n++) {
-          qtempl[R_AUX + n] = q(ivm, QFX + n) + 0.5 * dq(ivm, QFX + n);
-          qtempr[R_AUX + n] = q(iv, QFX + n) - 0.5 * dq(iv, QFX + n);
-        }
+      for (int n = 0; n < NUM_AUX; n++) {
+        pc_cmpflx_passive(
+          ustar, flux_tmp[URHO], qtempl[R_AUX + n], qtempr[R_AUX + n],
+          flux_tmp[UFX + n]);
+      }
 #endif
 #if NUM_LIN > 0
-        const int R_LIN = R_Y + NUM_SPECIES + NUM_AUX;
-        for (int n = 0; n < NUM_LIN; n++) {
-          qtempl[R_LIN + n] = q(ivm, QLIN + n) + 0.5 * dq(ivm, QLIN + n);
-          qtempr[R_LIN + n] = q(iv, QLIN + n) - 0.5 * dq(iv, QLIN + n);
-        }
+      for (int n = 0; n < NUM_LIN; n++) {
+        pc_cmpflx_passive(
+          ustar, qint_iu, qtempl[R_LIN + n], qtempr[R_LIN + n],
+          flux_tmp[ULIN + n]);
+      }
 #endif
+    } else {
+      amrex::Real maxeigval = 0.0;
+      laxfriedrich_flux(
+        qtempl[R_RHO], qtempl[R_UN], qtempl[R_UT1], qtempl[R_UT2],
+        qtempl[R_P], spl, qtempr[R_RHO], qtempr[R_UN], qtempr[R_UT1],
+        qtempr[R_UT2], qtempr[R_P], spr, bc_test_val, cavg, ustar,
+        maxeigval, flux_tmp[URHO], &flux_tmp[UFS], flux_tmp[f_idx[0]],
+        flux_tmp[f_idx[1]], flux_tmp[f_idx[2]], flux_tmp[UEDEN],
+        flux_tmp[UEINT]);
+#if NUM_ADV > 0
+      for (int n = 0; n < NUM_ADV; n++) {
+        pc_lax_cmpflx_passive(
+          qtempl[R_UN], qtempr[R_UN], qtempl[R_RHO], qtempr[R_RHO],
+          qtempl[R_ADV + n], qtempr[R_ADV + n], maxeigval,
+          flux_tmp[UFA + n]);
+      }
+#endif
+#if NUM_AUX > 0
+      for (int n = 0; n < NUM_AUX; n++) {
+        pc_lax_cmpflx_passive(
+          qtempl[R_UN], qtempr[R_UN], qtempl[R_RHO], qtempr[R_RHO],
+          qtempl[R_AUX + n], qtempr[R_AUX + n], maxeigval,
+          flux_tmp[UFX + n]);
+      }
+#endif
+#if NUM_LIN > 0
+      for (int n = 0; n < NUM_LIN; n++) {
+        pc_lax_cmpflx_passive(
+          qtempl[R_UN], qtempr[R_UN], 1., 1., qtempl[R_LIN + n],
+          qtempr[R_LIN + n], maxeigval, flux_tmp[ULIN + n]);
+      }
+#endif
+    }
+    flux_tmp[UTEMP] = 0.0;
+    for (int ivar = 0; ivar < NVAR; ivar++) {
+      flx(iv, ivar) += flux_tmp[ivar] * area(i, j, k);
+    }
+  });
+}
 
-        const amrex::Real cavg = 0.5 * (qaux(iv, QC) + qaux(ivm, QC));
+#ifndef AMREX_USE_GPU
+// Riemann fluxes of the faces of ebox for pc_compute_hyp_mol_flux, with the
+// faces of each pencil along i solved together by riemann_batch
+void
+pc_mol_flux_batch(
+  const amrex::Box& ebox,
+  const int dir,
+  const amrex::GpuArray<const int, 3>& q_idx,
+  const amrex::GpuArray<const int, 3>& f_idx,
+  const amrex::Array4<const amrex::Real>& q,
+  const amrex::Array4<const amrex::Real>& qaux,
+  const amrex::Array4<const amrex::Real>& dq,
+  const amrex::Array4<amrex::Real>& flx,
+  const amrex::Array4<const amrex::Real>& area,
+  const int mol_iorder)
+{
+  using namespace MOLFace;
+  constexpr int B = riemann_batch_size;
+  const int bc_test_val = 1;
+  // Without slopes the face states are the cell states, whose sound speeds
+  // are already in qaux
+  const bool cell_states = (mol_iorder == 1);
+  const amrex::IntVect ivd = amrex::IntVect::TheDimensionVector(dir);
+  const auto lo = amrex::lbound(ebox);
+  const auto hi = amrex::ubound(ebox);
 
-        amrex::Real spl[NUM_SPECIES];
-        for (int n = 0; n < NUM_SPECIES; n++) {
-          spl[n] = qtempl[R_Y + n];
-        }
+  RiemannBatch b;
+  amrex::Real qtempl[B][R_NUM];
+  amrex::Real qtempr[B][R_NUM];
+  for (int k = lo.z; k <= hi.z; k++) {
+    for (int j = lo.y; j <= hi.y; j++) {
+      for (int i0 = lo.x; i0 <= hi.x; i0 += B) {
+        b.n = amrex::min(B, hi.x - i0 + 1);
+        for (int f = 0; f < b.n; f++) {
+          const amrex::IntVect iv{AMREX_D_DECL(i0 + f, j, k)};
+          const amrex::IntVect ivm(iv - ivd);
+          for (int c = 0; c < R_NUM; c++) {
+            qtempl[f][c] = 0.0;
+            qtempr[f][c] = 0.0;
+          }
+          mol_face_states(iv, ivm, q_idx, q, qaux, dq, qtempl[f], qtempr[f]);
 
-        amrex::Real spr[NUM_SPECIES];
-        for (int n = 0; n < NUM_SPECIES; n++) {
-          spr[n] = qtempr[R_Y + n];
+          b.rl[f] = qtempl[f][R_RHO];
+          b.ul[f] = qtempl[f][R_UN];
+          b.vl[f] = qtempl[f][R_UT1];
+          b.v2l[f] = qtempl[f][R_UT2];
+          b.pl[f] = qtempl[f][R_P];
+          b.rr[f] = qtempr[f][R_RHO];
+          b.ur[f] = qtempr[f][R_UN];
+          b.vr[f] = qtempr[f][R_UT1];
+          b.v2r[f] = qtempr[f][R_UT2];
+          b.pr[f] = qtempr[f][R_P];
+          for (int n = 0; n < NUM_SPECIES; n++) {
+            b.spl[n][f] = qtempl[f][R_Y + n];
+            b.spr[n][f] = qtempr[f][R_Y + n];
+          }
+          b.cav[f] = 0.5 * (qaux(iv, QC) + qaux(ivm, QC));
+          if (cell_states) {
+            b.cl[f] = qaux(ivm, QC);
+            b.cr[f] = qaux(iv, QC);
+          }
         }
 
-        amrex::Real flux_tmp[NVAR] = {0.0};
-        amrex::Real ustar = 0.0;
-
-        if (!use_laxf_flux) {
-          amrex::Real qint_iu = 0.0, tmp1 = 0.0, tmp2 = 0.0, tmp3 = 0.0,
-                      tmp4 = 0.0;
-          riemann(
-            qtempl[R_RHO], qtempl[R_UN], qtempl[R_UT1], qtempl[R_UT2],
-            qtempl[R_P], spl, qtempr[R_RHO], qtempr[R_UN], qtempr[R_UT1],
-            qtempr[R_UT2], qtempr[R_P], spr, bc_test_val, cavg, ustar,
-            flux_tmp[URHO], &flux_tmp[UFS], flux_tmp[f_idx[0]],
-            flux_tmp[f_idx[1]], flux_tmp[f_idx[2]], flux_tmp[UEDEN],
-            flux_tmp[UEINT], qint_iu, tmp1, tmp2, tmp3, tmp4);
+        riemann_batch(b, bc_test_val, cell_states);
+
+        for (int f = 0; f < b.n; f++) {
+          const amrex::IntVect iv{AMREX_D_DECL(i0 + f, j, k)};
+          const amrex::Real ustar = b.ustar[f];
+          amrex::Real flux_tmp[NVAR] = {0.0};
+          flux_tmp[URHO] = b.uflx_rho[f];
+          for (int n = 0; n < NUM_SPECIES; n++) {
+            flux_tmp[UFS + n] = b.uflx_rhoY[n][f];
+          }
+          flux_tmp[f_idx[0]] = b.uflx_u[f];
+          flux_tmp[f_idx[1]] = b.uflx_v[f];
+          flux_tmp[f_idx[2]] = b.uflx_w[f];
+          flux_tmp[UEDEN] = b.uflx_eden[f];
+          flux_tmp[UEINT] = b.uflx_eint[f];
 #if NUM_ADV > 0
           for (int n = 0; n < NUM_ADV; n++) {
             pc_cmpflx_passive(
-              ustar, flux_tmp[URHO], qtempl[R_ADV + n], qtempr[R_ADV + n],
-              flux_tmp[UFA + n]);
+              ustar, flux_tmp[URHO], qtempl[f][R_ADV + n],
+              qtempr[f][R_ADV + n], flux_tmp[UFA + n]);
           }
 #endif
 #if NUM_AUX > 0
           for (int n = 0; n < NUM_AUX; n++) {
             pc_cmpflx_passive(
-              ustar, flux_tmp[URHO], qtempl[R_AUX + n], qtempr[R_AUX + n],
-              flux_tmp[UFX + n]);
+              ustar, flux_tmp[URHO], qtempl[f][R_AUX + n],
+              qtempr[f][R_AUX + n], flux_tmp[UFX + n]);
           }
 #endif
 #if NUM_LIN > 0
           for (int n = 0; n < NUM_LIN; n++) {
             pc_cmpflx_passive(
-              ustar, qint_iu, qtempl[R_LIN + n], qtempr[R_LIN + n],
-              flux_tmp[ULIN + n]);
-          }
-#endif
-        } else {
-          amrex::Real maxeigval = 0.0;
-          laxfriedrich_flux(
-            qtempl[R_RHO], qtempl[R_UN], qtempl[R_UT1], qtempl[R_UT2],
-            qtempl[R_P], spl, qtempr[R_RHO], qtempr[R_UN], qtempr[R_UT1],
-            qtempr[R_UT2], qtempr[R_P], spr, bc_test_val, cavg, ustar,
-            maxeigval, flux_tmp[URHO], &flux_tmp[UFS], flux_tmp[f_idx[0]],
-            flux_tmp[f_idx[1]], flux_tmp[f_idx[2]], flux_tmp[UEDEN],
-            flux_tmp[UEINT]);
-#if NUM_ADV > 0
-          for (int n = 0; n < NUM_ADV; n++) {
-            pc_lax_cmpflx_passive(
-              qtempl[R_UN], qtempr[R_UN], qtempl[R_RHO], qtempr[R_RHO],
-              qtempl[R_ADV + n], qtempr[R_ADV + n], maxeigval,
-              flux_tmp[UFA + n]);
+              ustar, b.qint_iu[f], qtempl[f][R_LIN + n],
+              qtempr[f][R_LIN + n], flux_tmp[ULIN + n]);
           }
 #endif
-#if NUM_AUX > 0
-          for (int n = 0; n < NUM_AUX; n++) {
-            pc_lax_cmpflx_passive(
-              qtempl[R_UN], qtempr[R_UN], qtempl[R_RHO], qtempr[R_RHO],
-              qtempl[R_AUX + n], qtempr[R_AUX + n], maxeigval,
-              flux_tmp[UFX + n]);
+          flux_tmp[UTEMP] = 0.0;
+          for (int ivar = 0; ivar < NVAR; ivar++) {
+            flx(iv, ivar) += flux_tmp[ivar] * area(iv);
           }
+        }
+      }
+    }
+  }
+}
 #endif
-#if NUM_LIN > 0
-          for (int n = 0; n < NUM_LIN; n++) {
-            pc_lax_cmpflx_passive(
-              qtempl[R_UN], qtempr[R_UN], 1., 1., qtempl[R_LIN + n],
-              qtempr[R_LIN + n], maxeigval, flux_tmp[ULIN + n]);
-          }
+} // namespace
+
+void
+pc_compute_hyp_mol_flux(
+  const amrex::Box& cbox,
+  const amrex::Array4<const amrex::Real>& q,
+  const amrex::Array4<const amrex::Real>& qaux,
+  const amrex::GpuArray<amrex::Array4<amrex::Real>, AMREX_SPACEDIM>& flx,
+  const amrex::GpuArray<const amrex::Array4<const amrex::Real>, AMREX_SPACEDIM>&
+    area,
+  const int mol_iorder,
+  const bool use_laxf_flux,
+  const amrex::Array4<amrex::EBCellFlag const>& flags)
+{
+  for (int dir = 0; dir < AMREX_SPACEDIM; dir++) {
+    amrex::FArrayBox dq_fab(cbox, QVAR, pc_scratch_arena());
+    auto const& dq = dq_fab.array();
+    setV(cbox, QVAR, dq, 0.0);
+
+    // dimensional indexing
+    const amrex::GpuArray<const int, 3> bdim{
+      {static_cast<int>(dir == 0), static_cast<int>(dir == 1),
+       static_cast<int>(dir == 2)}};
+    const amrex::GpuArray<const int, 3> q_idx{
+      {bdim[0] * QU + bdim[1] * QV + bdim[2] * QW,
+       bdim[0] * QV + bdim[1] * QU + bdim[2] * QU,
+       bdim[0] * QW + bdim[1] * QW + bdim[2] * QV}};
+    const amrex::GpuArray<const int, 3> f_idx{
+      {bdim[0] * UMX + bdim[1] * UMY + bdim[2] * UMZ,
+       bdim[0] * UMY + bdim[1] * UMX + bdim[2] * UMX,
+       bdim[0] * UMZ + bdim[1] * UMZ + bdim[2] * UMY}};
+
+    if (mol_iorder != 1) {
+      amrex::ParallelFor(
+        cbox, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
+          mol_slope(i, j, k, dir, q_idx, q, qaux, dq, flags);
+        });
+    }
+    const amrex::Box tbox = amrex::grow(cbox, dir, -1);
+    const amrex::Box ebox = amrex::surroundingNodes(tbox, dir);
+#ifndef AMREX_USE_GPU
+    if (!use_laxf_flux) {
+      pc_mol_flux_batch(
+        ebox, dir, q_idx, f_idx, q, qaux, dq, flx[dir], area[dir], mol_iorder);
+      continue;
+    }
 #endif
-        }
-        flux_tmp[UTEMP] = 0.0;
-        for (int ivar = 0; ivar < NVAR; ivar++) {
-          flx[dir](iv, ivar) += flux_tmp[ivar] * area[dir](i, j, k);
-        }
-      });
+    if (use_laxf_flux) {
+      pc_mol_face_fluxes<true>(
+        ebox, dir, q_idx, f_idx, q, qaux, dq, flx[dir], area[dir]);
+    } else {
+      pc_mol_face_fluxes<false>(
+        ebox, dir, q_idx, f_idx, q, qaux, dq, flx[dir], area[dir]);
+    }
   }
 }
 
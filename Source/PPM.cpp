@@ -1,21 +1,22 @@
 #include "Godunov.H"
 #include "PPM.H"
 #include "WENO.H"
+#include "Utilities.H"
 
+namespace {
+// trace_ppm specialized on flattening and on the hybrid WENO scheme, with
+// WenoScheme = -1 for the original PPM reconstruction
+template <bool UseFlattening, int WenoScheme>
 void
-trace_ppm(
+trace_ppm_kernel(
   const amrex::Box& bx,
   const int idir,
   amrex::Array4<amrex::Real const> const& q_arr,
-  amrex::Array4<amrex::Real const> const& /*srcQ*/,
   amrex::Array4<amrex::Real> const& qm,
   amrex::Array4<amrex::Real> const& qp,
   const amrex::Box& vbx,
   const amrex::Real dt,
-  const amrex::GpuArray<amrex::Real, AMREX_SPACEDIM>& dx,
-  const bool use_flattening,
-  const bool use_hybrid_weno,
-  const int weno_scheme)
+  const amrex::GpuArray<amrex::Real, AMREX_SPACEDIM>& dx)
 {
   // here, lo and hi are the range we loop over -- this can include ghost cells
   // vlo and vhi are the bounds of the valid box (no ghost cells)
@@ -107,7 +108,7 @@ trace_ppm(
 
     amrex::Real flat = 1.0;
     // Calculate flattening in-place
-    if (use_flattening) {
+    if constexpr (UseFlattening) {
       for (int dir_flat = 0; dir_flat < AMREX_SPACEDIM; dir_flat++) {
         flat = amrex::min<amrex::Real>(
           flat, flatten(AMREX_D_DECL(i, j, k), dir_flat, q_arr));
@@ -118,7 +119,7 @@ trace_ppm(
     amrex::Real Im[QVAR][3];
 
     for (int n = 0; n < QVAR; n++) {
-      if (use_hybrid_weno && ((weno_scheme == 0) || (weno_scheme == 1))) {
+      if constexpr ((WenoScheme == 0) || (WenoScheme == 1)) {
 
         amrex::Real s_weno5[5];
         s_weno5[0] = q_arr(ivm2, n);
@@ -129,14 +130,14 @@ trace_ppm(
 
         amrex::Real sm = 0.0;
         amrex::Real sp = 0.0;
-        if (weno_scheme == 0) {
+        if constexpr (WenoScheme == 0) {
           weno_reconstruct_5js(s_weno5, sm, sp);
-        } else if (weno_scheme == 1) {
+        } else {
           weno_reconstruct_5z(s_weno5, sm, sp);
         }
         ppm_int_profile(sm, sp, s_weno5[2], un, cc, dtdx, Ip[n], Im[n]);
 
-      } else if (use_hybrid_weno && weno_scheme == 2) {
+      } else if constexpr (WenoScheme == 2) {
 
         amrex::Real s_weno7[7];
         const amrex::IntVect ivm3(
@@ -156,7 +157,7 @@ trace_ppm(
         weno_reconstruct_7z(s_weno7, sm, sp);
         ppm_int_profile(sm, sp, s_weno7[3], un, cc, dtdx, Ip[n], Im[n]);
 
-      } else if (use_hybrid_weno && weno_scheme == 3) {
+      } else if constexpr (WenoScheme == 3) {
 
         amrex::Real s_weno3[3];
         if (idir == 0) {
@@ -422,3 +423,33 @@ trace_ppm(
     }
   });
 }
+} // namespace
+
+void
+trace_ppm(
+  const amrex::Box& bx,
+  const int idir,
+  amrex::Array4<amrex::Real const> const& q_arr,
+  amrex::Array4<amrex::Real const> const& /*srcQ*/,
+  amrex::Array4<amrex::Real> const& qm,
+  amrex::Array4<amrex::Real> const& qp,
+  const amrex::Box& vbx,
+  const amrex::Real dt,
+  const amrex::GpuArray<amrex::Real, AMREX_SPACEDIM>& dx,
+  const bool use_flattening,
+  const bool use_hybrid_weno,
+  const int weno_scheme)
+{
+  // The flattening coefficient only enters the original PPM reconstruction
+  const bool weno = use_hybrid_weno && (weno_scheme >= 0) && (weno_scheme <= 3);
+  if (weno) {
+    pc_static_dispatch<0, 1, 2, 3>(weno_scheme, [&](auto scheme) {
+      trace_ppm_kernel<false, decltype(scheme)::value>(
+        bx, idir, q_arr, qm, qp, vbx, dt, dx);
+    });
+  } else if (use_flattening) {
+    trace_ppm_kernel<true, -1>(bx, idir, q_arr, qm, qp, vbx, dt, dx);
+  } else {
+    trace_ppm_kernel<false, -1>(bx, idir, q_arr, qm, qp, vbx, dt, dx);
+  }
+}
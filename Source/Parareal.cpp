@@ -0,0 +1,368 @@
+#include <iostream>
+#include <string>
+
+#include <AMReX_ParmParse.H>
+#include <AMReX_ParallelDescriptor.H>
+
+#include "PeleC.H"
+#include "Parareal.H"
+
+namespace {
+int parareal_ngroups = 1;
+int parareal_group = 0;
+#ifdef AMREX_USE_MPI
+bool parareal_mpi_init = false;
+MPI_Comm parareal_group_comm = MPI_COMM_NULL;
+// Ranks of the same index in each group, ordered by group
+MPI_Comm parareal_cross_comm = MPI_COMM_NULL;
+#endif
+} // namespace
+
+int
+PararealDriver::splitCommunicator(int argc, char* argv[], MPI_Comm& comm)
+{
+  comm = MPI_COMM_WORLD;
+  const std::string key = "parareal.ngroups=";
+  int ngroups = 1;
+  for (int i = 1; i < argc; i++) {
+    const std::string arg(argv[i]);
+    if (arg.compare(0, key.size(), key) == 0) {
+      ngroups = std::stoi(arg.substr(key.size()));
+    }
+  }
+  if (ngroups <= 1) {
+    return 1;
+  }
+
+#ifdef AMREX_USE_MPI
+  int initialized = 0;
+  MPI_Initialized(&initialized);
+  if (initialized == 0) {
+    MPI_Init(&argc, &argv);
+    parareal_mpi_init = true;
+  }
+  int rank = 0;
+  int nprocs = 1;
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &nprocs);
+  if (nprocs % ngroups != 0) {
+    if (rank == 0) {
+      std::cerr << "parareal.ngroups must divide the number of MPI ranks"
+                << std::endl;
+    }
+    MPI_Abort(MPI_COMM_WORLD, 1);
+  }
+  const int group_size = nprocs / ngroups;
+  parareal_ngroups = ngroups;
+  parareal_group = rank / group_size;
+  MPI_Comm_split(MPI_COMM_WORLD, parareal_group, rank, &parareal_group_comm);
+  MPI_Comm_split(
+    MPI_COMM_WORLD, rank % group_size, parareal_group, &parareal_cross_comm);
+  comm = parareal_group_comm;
+  return ngroups;
+#else
+  // Rejected by setup
+  return 1;
+#endif
+}
+
+void
+PararealDriver::finalize()
+{
+#ifdef AMREX_USE_MPI
+  if (parareal_cross_comm != MPI_COMM_NULL) {
+    MPI_Comm_free(&parareal_cross_comm);
+    MPI_Comm_free(&parareal_group_comm);
+  }
+  if (parareal_mpi_init) {
+    MPI_Finalize();
+  }
+#endif
+}
+
+void
+PararealDriver::setup()
+{
+  int ngroups = 1;
+  amrex::ParmParse("parareal").query("ngroups", ngroups);
+  if (ngroups != parareal_ngroups) {
+    amrex::Abort(
+      "parareal.ngroups must be given on the command line of an MPI run");
+  }
+  if (parareal_group == 0) {
+    return;
+  }
+  amrex::ParmParse pp("amr");
+  pp.add("plot_int", -1);
+  pp.add("small_plot_int", -1);
+  pp.add("check_int", -1);
+  pp.add("plot_per", -1.0);
+  pp.add("small_plot_per", -1.0);
+  pp.add("check_per", -1.0);
+  pp.remove("data_log");
+  pp.remove("grid_log");
+  pp.remove("run_log");
+  pp.remove("run_log_terse");
+}
+
+bool
+PararealDriver::writesOutput()
+{
+  return parareal_group == 0;
+}
+
+PararealDriver::PararealDriver(amrex::Amr& amr)
+  : m_amr(amr), m_ngroups(parareal_ngroups), m_group(parareal_group)
+{
+  amrex::ParmParse pp("parareal");
+  pp.query("slice_steps", m_slice_steps);
+  pp.query("coarse_factor", m_coarse_factor);
+  pp.query("coarse_sdc_iters", m_coarse_sdc_iters);
+  m_max_iters = m_ngroups;
+  pp.query("max_iters", m_max_iters);
+  pp.query("tol", m_tol);
+
+  m_fine_dt = PeleC::getFixedDt();
+  m_fine_sdc_iters = PeleC::getSDCIters();
+  bool do_mol = false;
+  amrex::ParmParse("pelec").query("do_mol", do_mol);
+  if (do_mol) {
+    amrex::Abort("parareal requires the SDC advance (pelec.do_mol = 0)");
+  }
+  if (m_fine_dt <= 0.0) {
+    amrex::Abort("parareal requires pelec.fixed_dt");
+  }
+  if (amr.maxLevel() > 0) {
+    amrex::Abort("parareal requires amr.max_level = 0");
+  }
+  if ((m_coarse_factor < 1) || (m_slice_steps % m_coarse_factor != 0)) {
+    amrex::Abort("parareal.coarse_factor must divide parareal.slice_steps");
+  }
+  m_max_iters = amrex::max(1, amrex::min(m_max_iters, m_ngroups));
+}
+
+void
+PararealDriver::run(int max_step, amrex::Real stop_time)
+{
+  BL_PROFILE("PararealDriver::run()");
+
+  const int window_steps = m_ngroups * m_slice_steps;
+  const amrex::Real window_time = window_steps * m_fine_dt;
+  while (m_amr.okToContinue() != 0) {
+    const int step = m_amr.levelSteps(0);
+    const amrex::Real time = m_amr.cumTime();
+    if (
+      ((max_step >= 0) && (step + window_steps > max_step)) ||
+      ((stop_time >= 0.0) &&
+       (time + window_time > stop_time * (1.0 + 1.0e-12)))) {
+      break;
+    }
+
+    advanceWindow(time);
+
+    const int new_step = step + window_steps;
+    const amrex::Real new_time = time + window_time;
+    m_amr.getLevel(0).setTimeLevel(new_time, m_fine_dt, m_fine_dt);
+    m_amr.setCumTime(new_time);
+    m_amr.setLevelSteps(0, new_step);
+
+    if (writesOutput()) {
+      amrex::Print() << "\nParareal window to time " << new_time << " (step "
+                     << new_step << ")" << std::endl;
+      const int plot_int = m_amr.plotInt();
+      const int check_int = m_amr.checkInt();
+      if ((plot_int > 0) && (new_step / plot_int > step / plot_int)) {
+        m_amr.writePlotFile();
+      }
+      if ((check_int > 0) && (new_step / check_int > step / check_int)) {
+        m_amr.checkPoint();
+      }
+    }
+  }
+}
+
+void
+PararealDriver::advanceWindow(amrex::Real time)
+{
+  BL_PROFILE("PararealDriver::advanceWindow()");
+
+  const amrex::Real slice_time = m_slice_steps * m_fine_dt;
+  const amrex::Real t_slice = time + m_group * slice_time;
+
+  amrex::MultiFab U;
+  getState(U);
+  amrex::MultiFab U_prev;
+  amrex::MultiFab F;
+  amrex::MultiFab G_old;
+  amrex::MultiFab G_new;
+  defineState(U_prev, U);
+  defineState(F, U);
+  defineState(G_old, U);
+  defineState(G_new, U);
+  const int ncomp = U.nComp();
+
+  // Coarse prediction of the start of this slice and its coarse propagation
+  for (int s = 0; s < m_group; s++) {
+    propagate(U, time + s * slice_time, true);
+  }
+  amrex::MultiFab::Copy(G_old, U, 0, 0, ncomp, 0);
+  propagate(G_old, t_slice, true);
+
+  for (int k = 1; k <= m_max_iters; k++) {
+    amrex::MultiFab::Copy(F, U, 0, 0, ncomp, 0);
+    propagate(F, t_slice, false);
+
+    // Corrected start of this slice, then of the next one:
+    // G(U^k) + F(U^{k-1}) - G(U^{k-1})
+    amrex::MultiFab::Copy(U_prev, U, 0, 0, ncomp, 0);
+    if (m_group > 0) {
+      exchange(U, m_group - 1, m_group);
+    }
+    amrex::MultiFab::Copy(G_new, U, 0, 0, ncomp, 0);
+    propagate(G_new, t_slice, true);
+    amrex::MultiFab::Saxpy(F, 1.0, G_new, 0, 0, ncomp, 0);
+    amrex::MultiFab::Saxpy(F, -1.0, G_old, 0, 0, ncomp, 0);
+    std::swap(G_old, G_new);
+    if (m_group < m_ngroups - 1) {
+      exchange(F, m_group, m_group + 1);
+    }
+
+    // After k iterations the first k slices are exact
+    const amrex::Real change = relativeChange(U_prev, U);
+    if (writesOutput()) {
+      amrex::Print() << "Parareal iteration " << k << " of " << m_max_iters
+                     << ": relative change " << change << std::endl;
+    }
+    if ((k == m_ngroups) || (change < m_tol)) {
+      break;
+    }
+  }
+
+  // The end of the last slice starts the next window
+  broadcast(F, m_ngroups - 1);
+  setState(F);
+}
+
+void
+PararealDriver::propagate(amrex::MultiFab& U, amrex::Real time, bool coarse)
+{
+  BL_PROFILE("PararealDriver::propagate()");
+
+  const amrex::Real dt = coarse ? m_coarse_factor * m_fine_dt : m_fine_dt;
+  const int nsteps = coarse ? m_slice_steps / m_coarse_factor : m_slice_steps;
+  const int nsweeps = coarse ? m_coarse_sdc_iters : m_fine_sdc_iters;
+
+  setState(U);
+  auto& lev = static_cast<PeleC&>(m_amr.getLevel(0));
+  lev.setTimeLevel(time, dt, dt);
+  for (int n = 0; n < nsteps; n++) {
+    lev.advance_propagator(time + n * dt, dt, nsweeps, coarse);
+  }
+  getState(U);
+}
+
+void
+PararealDriver::getState(amrex::MultiFab& U)
+{
+  amrex::AmrLevel& lev = m_amr.getLevel(0);
+  const amrex::MultiFab& S = lev.get_new_data(State_Type);
+  const amrex::MultiFab& R = lev.get_new_data(Reactions_Type);
+  if (!U.isDefined()) {
+    // Pinned, so that it can be handed to MPI on the host
+    U.define(
+      S.boxArray(), S.DistributionMap(), S.nComp() + R.nComp(), 0,
+      amrex::MFInfo().SetArena(amrex::The_Pinned_Arena()));
+  }
+  amrex::MultiFab::Copy(U, S, 0, 0, S.nComp(), 0);
+  amrex::MultiFab::Copy(U, R, 0, S.nComp(), R.nComp(), 0);
+}
+
+void
+PararealDriver::setState(const amrex::MultiFab& U)
+{
+  amrex::AmrLevel& lev = m_amr.getLevel(0);
+  amrex::MultiFab& S = lev.get_new_data(State_Type);
+  amrex::MultiFab& R = lev.get_new_data(Reactions_Type);
+  amrex::MultiFab::Copy(S, U, 0, 0, S.nComp(), 0);
+  amrex::MultiFab::Copy(R, U, S.nComp(), 0, R.nComp(), 0);
+}
+
+void
+PararealDriver::defineState(
+  amrex::MultiFab& U, const amrex::MultiFab& like) const
+{
+  U.define(
+    like.boxArray(), like.DistributionMap(), like.nComp(), 0,
+    amrex::MFInfo().SetArena(amrex::The_Pinned_Arena()));
+}
+
+void
+PararealDriver::exchange(amrex::MultiFab& U, int from, int to) const
+{
+#ifdef AMREX_USE_MPI
+  BL_PROFILE("PararealDriver::exchange()");
+  amrex::Gpu::streamSynchronize();
+  const auto mpi_real = amrex::ParallelDescriptor::Mpi_typemap<
+    amrex::Real>::type();
+  for (amrex::MFIter mfi(U); mfi.isValid(); ++mfi) {
+    amrex::FArrayBox& fab = U[mfi];
+    const int count = static_cast<int>(fab.box().numPts() * fab.nComp());
+    if (m_group == from) {
+      MPI_Send(
+        fab.dataPtr(), count, mpi_real, to, mfi.index(), parareal_cross_comm);
+    } else if (m_group == to) {
+      MPI_Recv(
+        fab.dataPtr(), count, mpi_real, from, mfi.index(),
+        parareal_cross_comm, MPI_STATUS_IGNORE);
+    }
+  }
+#else
+  amrex::ignore_unused(U, from, to);
+#endif
+}
+
+void
+PararealDriver::broadcast(amrex::MultiFab& U, int root) const
+{
+#ifdef AMREX_USE_MPI
+  BL_PROFILE("PararealDriver::broadcast()");
+  amrex::Gpu::streamSynchronize();
+  const auto mpi_real = amrex::ParallelDescriptor::Mpi_typemap<
+    amrex::Real>::type();
+  for (amrex::MFIter mfi(U); mfi.isValid(); ++mfi) {
+    amrex::FArrayBox& fab = U[mfi];
+    const int count = static_cast<int>(fab.box().numPts() * fab.nComp());
+    MPI_Bcast(fab.dataPtr(), count, mpi_real, root, parareal_cross_comm);
+  }
+#else
+  amrex::ignore_unused(U, root);
+#endif
+}
+
+amrex::Real
+PararealDriver::relativeChange(
+  amrex::MultiFab& prev, const amrex::MultiFab& cur) const
+{
+  amrex::MultiFab::Subtract(prev, cur, 0, 0, NVAR, 0);
+  amrex::Vector<int> comps(NVAR);
+  for (int n = 0; n < NVAR; n++) {
+    comps[n] = n;
+  }
+  amrex::Vector<amrex::Real> norms = prev.norm0(comps, 0, true);
+  const amrex::Vector<amrex::Real> refs = cur.norm0(comps, 0, true);
+  norms.insert(norms.end(), refs.begin(), refs.end());
+#ifdef AMREX_USE_MPI
+  MPI_Allreduce(
+    MPI_IN_PLACE, norms.data(), 2 * NVAR,
+    amrex::ParallelDescriptor::Mpi_typemap<amrex::Real>::type(), MPI_MAX,
+    MPI_COMM_WORLD);
+#endif
+
+  amrex::Real change = 0.0;
+  for (int n = 0; n < NVAR; n++) {
+    if (norms[NVAR + n] > 0.0) {
+      change = amrex::max(change, norms[n] / norms[NVAR + n]);
+    }
+  }
+  return change;
+}
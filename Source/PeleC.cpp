@@ -31,6 +31,7 @@ using namespace MASA;
 #include "Utilities.H"
 #include "Tagging.H"
 #include "IndexDefines.H"
+#include "ScratchArena.H"
 
 #ifdef PELE_ENABLE_FPE_TRAP
 #if defined(__linux__)
@@ -45,6 +46,7 @@ int PeleC::verbose = 0;
 int PeleC::radius_grow = 1;
 amrex::BCRec PeleC::phys_bc;
 amrex::Real PeleC::frac_change = std::numeric_limits<amrex::Real>::max();
+amrex::Vector<DtControl> PeleC::dt_ctrl;
 int PeleC::Density = -1;
 int PeleC::Eden = -1;
 int PeleC::Eint = -1;
@@ -93,6 +95,8 @@ bool PeleC::body_state_set = false;
 amrex::GpuArray<amrex::Real, NVAR> PeleC::body_state;
 
 bool PeleC::do_react_load_balance = false;
+std::unique_ptr<ChemCache> PeleC::chem_cache;
+MOLRKScheme PeleC::mol_rk;
 bool PeleC::do_mol_load_balance = false;
 
 amrex::Vector<std::string> PeleC::spec_names;
@@ -133,6 +137,18 @@ ebInitialized(bool eb_init_val)
   eb_initialized = eb_init_val;
 }
 
+amrex::Real
+PeleC::getFixedDt()
+{
+  return fixed_dt;
+}
+
+int
+PeleC::getSDCIters()
+{
+  return sdc_iters;
+}
+
 int
 PeleC::getEBMaxLevel()
 {
@@ -337,8 +353,36 @@ PeleC::read_params()
   if (cfl <= 0.0 || cfl > 1.0) {
     amrex::Error("Invalid CFL factor; must be between zero and one.");
   }
-  if (do_hydro && do_mol && (cfl > 0.3)) {
-    amrex::Print() << "WARNING -- CFL should be <= 0.3 when using MOL hydro."
+  mol_rk = make_mol_rk_scheme(mol_rk_scheme);
+  if (do_mol && (mol_iters > 1) && (mol_rk.name != "ssprk2")) {
+    amrex::Error("pelec.mol_iters > 1 requires pelec.mol_rk_scheme = ssprk2");
+  }
+  if (diffusion_sts && ((!do_mol) || (mol_iters > 1))) {
+    amrex::Error("pelec.diffusion_sts requires do_mol = 1 and mol_iters = 1");
+  }
+  if (imex_acoustic && ((!do_mol) || (mol_iters > 1) || diffusion_sts)) {
+    amrex::Error(
+      "pelec.imex_acoustic requires do_mol = 1, mol_iters = 1 and "
+      "diffusion_sts = 0");
+  }
+  if (
+    mol_deep_halo &&
+    ((!do_mol) || (mol_rk.name != "ssprk2") || diffusion_sts ||
+     imex_acoustic || use_explicit_filter || do_isothermal_walls ||
+     do_spray_particles)) {
+    amrex::Error(
+      "pelec.mol_deep_halo requires do_mol = 1 with the ssprk2 scheme, "
+      "without diffusion_sts, imex_acoustic, use_explicit_filter, "
+      "do_isothermal_walls or spray particles");
+  }
+  if (diffusion_sts_max_stages < 2) {
+    amrex::Error("pelec.diffusion_sts_max_stages must be at least 2");
+  }
+  if (
+    do_hydro && do_mol && (!imex_acoustic) &&
+    (cfl > 0.3 * mol_rk.cfl_factor)) {
+    amrex::Print() << "WARNING -- CFL should be <= " << 0.3 * mol_rk.cfl_factor
+                   << " when using MOL hydro with " << mol_rk.name << "."
                    << std::endl;
   }
 
@@ -398,10 +442,37 @@ PeleC::read_params()
     amrex::Error("Cannot have max_dt < fixed_dt");
   }
 
+#ifdef AMREX_USE_GPU
+  if (chem_isat) {
+    amrex::Abort("pelec.chem_isat is not supported on GPUs");
+  }
+#endif
+
+  if (
+    chem_dmap_decoupled && (chem_dmap_strategy != "knapsack") &&
+    (chem_dmap_strategy != "sfc")) {
+    amrex::Error("PeleC::chem_dmap_strategy must be knapsack or sfc");
+  }
+
 #ifdef PELE_USE_SPRAY
   readSprayParams();
 #endif
 
+  if ((sdc_iters_tol > 0.0) && do_spray_particles) {
+    amrex::Error("pelec.sdc_iters_tol is not supported with spray particles");
+  }
+
+  if ((step_retries > 0) && (step_retry_factor < 2)) {
+    amrex::Error("pelec.step_retry_factor must be at least 2");
+  }
+
+  // The spray particles of all levels live in one container, which a level
+  // advance also changes through the virtual and ghost particles of its
+  // neighbours, so a level copy cannot restore them
+  if ((step_retries > 0) && do_spray_particles) {
+    amrex::Error("pelec.step_retries is not supported with spray particles");
+  }
+
 #ifdef PELE_USE_SOOT
   pp.query("add_soot_src", add_soot_src);
   pp.query("plot_soot", plot_soot);
@@ -591,13 +662,14 @@ PeleC::buildMetrics()
 
   volume.clear();
   volume.define(
-    grids, dmap, 1, numGrow(), amrex::MFInfo(), amrex::FArrayBoxFactory());
+    grids, dmap, 1, numGrowMetrics(), amrex::MFInfo(),
+    amrex::FArrayBoxFactory());
   geom.GetVolume(volume);
 
   for (int dir = 0; dir < AMREX_SPACEDIM; dir++) {
     area[dir].clear();
     area[dir].define(
-      getEdgeBoxArray(dir), dmap, 1, numGrow(), amrex::MFInfo(),
+      getEdgeBoxArray(dir), dmap, 1, numGrowMetrics(), amrex::MFInfo(),
       amrex::FArrayBoxFactory());
     geom.GetFaceArea(area[dir], dir);
   }
@@ -847,8 +919,6 @@ PeleC::estTimeStep(amrex::Real /*dt_old*/)
 
   const amrex::MultiFab& stateMF = get_new_data(State_Type);
 
-  const amrex::Real* dx = geom.CellSize();
-
   std::string limiter = "pelec.max_dt";
 
   // Start the hydro with the max_dt value, but divide by CFL
@@ -863,89 +933,49 @@ PeleC::estTimeStep(amrex::Real /*dt_old*/)
   amrex::Real estdt_edif = max_dt_over_cfl;
   if (do_hydro || do_mol || diffuse_vel || diffuse_temp || diffuse_enth) {
 
-    auto const& fact =
-      dynamic_cast<amrex::EBFArrayBoxFactory const&>(stateMF.Factory());
-    auto const& flags = fact.getMultiEBCellFlagFab();
-
-    amrex::Real AMREX_D_DECL(dx1 = dx[0], dx2 = dx[1], dx3 = dx[2]);
-
-    if (do_hydro) {
-      amrex::Real dt = amrex::ReduceMin(
-        stateMF, flags, 0,
-        [=] AMREX_GPU_HOST_DEVICE(
-          amrex::Box const& bx, const amrex::Array4<const amrex::Real>& fab_arr,
-          const amrex::Array4<const amrex::EBCellFlag>& flag_arr)
-          -> amrex::Real {
-          return pc_estdt_hydro(
-            bx, fab_arr, flag_arr, AMREX_D_DECL(dx1, dx2, dx3));
-        });
-      estdt_hydro = amrex::min<amrex::Real>(estdt_hydro, dt);
+    amrex::Real dts[4];
+    estTimeStepLimits(stateMF, dts);
+
+    // The MOL limits scale with the SSP coefficient of the RK scheme. With
+    // super-time-stepping, the diffusion limits scale with the gain of the
+    // largest RKL2 step allowed, taken twice per step. The IMEX advance has
+    // a convective hydro limit.
+    const amrex::Real rk_factor =
+      (do_mol && (!imex_acoustic)) ? mol_rk.cfl_factor : 1.0;
+    const amrex::Real diff_factor =
+      (do_mol && diffusion_sts) ? 2.0 * rkl2_gain(diffusion_sts_max_stages)
+                                : rk_factor;
+    estdt_hydro = amrex::min<amrex::Real>(estdt_hydro, rk_factor * dts[0]);
+    estdt_vdif = amrex::min<amrex::Real>(estdt_vdif, diff_factor * dts[1]);
+    estdt_tdif = amrex::min<amrex::Real>(estdt_tdif, diff_factor * dts[2]);
+    estdt_edif = amrex::min<amrex::Real>(estdt_edif, diff_factor * dts[3]);
+
+    // Most restrictive of the hydro and diffusion limits
+    std::string hydro_limiter = "hydro";
+    if (estdt_vdif < estdt_hydro) {
+      hydro_limiter = "veldif";
+      estdt_hydro = estdt_vdif;
     }
-
-    if (diffuse_vel) {
-      auto const& geomdata = geom.data();
-      auto const* ltransparm = trans_parms.device_trans_parm();
-      const ProbParmDevice* lprobparm = PeleC::d_prob_parm_device;
-      amrex::Real dt = amrex::ReduceMin(
-        stateMF, flags, 0,
-        [=] AMREX_GPU_HOST_DEVICE(
-          amrex::Box const& bx, const amrex::Array4<const amrex::Real>& fab_arr,
-          const amrex::Array4<const amrex::EBCellFlag>& flag_arr)
-          -> amrex::Real {
-          return pc_estdt_veldif(
-            bx, fab_arr, flag_arr, geomdata, ltransparm, *lprobparm);
-        });
-      estdt_vdif = amrex::min<amrex::Real>(estdt_vdif, dt);
+    if (estdt_tdif < estdt_hydro) {
+      hydro_limiter = "tempdif";
+      estdt_hydro = estdt_tdif;
     }
-
-    if (diffuse_temp) {
-      auto const& geomdata = geom.data();
-      auto const* ltransparm = trans_parms.device_trans_parm();
-      const ProbParmDevice* lprobparm = PeleC::d_prob_parm_device;
-      amrex::Real dt = amrex::ReduceMin(
-        stateMF, flags, 0,
-        [=] AMREX_GPU_HOST_DEVICE(
-          amrex::Box const& bx, const amrex::Array4<const amrex::Real>& fab_arr,
-          const amrex::Array4<const amrex::EBCellFlag>& flag_arr)
-          -> amrex::Real {
-          return pc_estdt_tempdif(
-            bx, fab_arr, flag_arr, geomdata, ltransparm, *lprobparm);
-        });
-      estdt_tdif = amrex::min<amrex::Real>(estdt_tdif, dt);
+    if (estdt_edif < estdt_hydro) {
+      hydro_limiter = "enthdif";
+      estdt_hydro = estdt_edif;
     }
 
-    if (diffuse_enth) {
-      auto const& geomdata = geom.data();
-      auto const* ltransparm = trans_parms.device_trans_parm();
-      const ProbParmDevice* lprobparm = PeleC::d_prob_parm_device;
-      amrex::Real dt = amrex::ReduceMin(
-        stateMF, flags, 0,
-        [=] AMREX_GPU_HOST_DEVICE(
-          amrex::Box const& bx, const amrex::Array4<const amrex::Real>& fab_arr,
-          const amrex::Array4<const amrex::EBCellFlag>& flag_arr)
-          -> amrex::Real {
-          return pc_estdt_enthdif(
-            bx, fab_arr, flag_arr, geomdata, ltransparm, *lprobparm);
-        });
-      estdt_edif = amrex::min<amrex::Real>(estdt_edif, dt);
-    }
-
-    estdt_hydro = amrex::min<amrex::Real>(
-      estdt_hydro,
-      amrex::min<amrex::Real>(
-        estdt_vdif, amrex::min<amrex::Real>(estdt_tdif, estdt_edif)));
-
-    amrex::ParallelDescriptor::ReduceRealMin(estdt_hydro);
     estdt_hydro *= cfl;
 
     if (verbose != 0) {
-      amrex::Print() << "...estimated hydro-limited timestep at level " << level
-                     << ": " << estdt_hydro << std::endl;
+      amrex::Print() << "...estimated " << hydro_limiter
+                     << "-limited timestep at level " << level << ": "
+                     << estdt_hydro << std::endl;
     }
 
     // Determine if this is more restrictive than the maximum timestep limiting
     if (estdt_hydro < estdt) {
-      limiter = "hydro";
+      limiter = hydro_limiter;
       estdt = estdt_hydro;
     }
   }
@@ -969,6 +999,67 @@ PeleC::estTimeStep(amrex::Real /*dt_old*/)
   return estdt;
 }
 
+void
+PeleC::estTimeStepLimits(const amrex::MultiFab& S, amrex::Real* dts)
+{
+  // Hydro, viscous, thermal and enthalpy diffusion limits of state S, before
+  // the CFL factor. Disabled limits are left at the largest real.
+  auto const& fact =
+    dynamic_cast<amrex::EBFArrayBoxFactory const&>(S.Factory());
+  auto const& flags = fact.getMultiEBCellFlagFab();
+
+  // All the enabled limits in a single pass
+  EstDtParm parm;
+  parm.hydro = do_hydro;
+  parm.convective = do_mol && imex_acoustic;
+  parm.acoustic_cfl = imex_acoustic_cfl;
+  parm.veldif = diffuse_vel;
+  parm.tempdif = diffuse_temp;
+  parm.enthdif = diffuse_enth;
+  auto const& geomdata = geom.data();
+  auto const* ltransparm = trans_parms.device_trans_parm();
+  const ProbParmDevice* lprobparm = PeleC::d_prob_parm_device;
+  constexpr amrex::Real huge = std::numeric_limits<amrex::Real>::max();
+
+  amrex::ReduceOps<
+    amrex::ReduceOpMin, amrex::ReduceOpMin, amrex::ReduceOpMin,
+    amrex::ReduceOpMin>
+    reduce_op;
+  amrex::ReduceData<amrex::Real, amrex::Real, amrex::Real, amrex::Real>
+    reduce_data(reduce_op);
+  using ReduceTuple = typename decltype(reduce_data)::Type;
+
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
+#endif
+  for (amrex::MFIter mfi(S, amrex::TilingIfNotGPU()); mfi.isValid(); ++mfi) {
+    const amrex::Box& bx = mfi.tilebox();
+    auto const& u = S.const_array(mfi);
+    auto const& flag = flags.const_array(mfi);
+    reduce_op.eval(
+      bx, reduce_data,
+      [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept -> ReduceTuple {
+        amrex::Real dt_h = huge, dt_v = huge, dt_t = huge, dt_e = huge;
+        if (!flag(i, j, k).isCovered()) {
+          pc_estdt(
+            i, j, k, u, geomdata, parm, ltransparm, *lprobparm, dt_h, dt_v,
+            dt_t, dt_e);
+        }
+        return {dt_h, dt_v, dt_t, dt_e};
+      });
+  }
+
+  ReduceTuple hv = reduce_data.value(reduce_op);
+  dts[0] = amrex::get<0>(hv);
+  dts[1] = amrex::get<1>(hv);
+  dts[2] = amrex::get<2>(hv);
+  dts[3] = amrex::get<3>(hv);
+  amrex::ParallelDescriptor::ReduceRealMin(dts, 4);
+  AMREX_ALWAYS_ASSERT_WITH_MESSAGE(
+    (dts[0] > 0.0) && (dts[1] > 0.0) && (dts[2] > 0.0) && (dts[3] > 0.0),
+    "ERROR: dt needs to be positive.");
+}
+
 void
 PeleC::computeNewDt(
   int finest_level,
@@ -995,6 +1086,21 @@ PeleC::computeNewDt(
     dt_min[i] = adv_level.estTimeStep(dt_level[i]);
   }
 
+  if ((fixed_dt <= 0.0) && dt_controller) {
+    const amrex::Real iter_tol = do_mol ? mol_iters_tol : sdc_iters_tol;
+    for (int i = 0; i <= finest_level; i++) {
+      const amrex::Real dt_est = dt_min[i];
+      dt_min[i] = dt_control(
+        getLevel(i).level_dt_control(), dt_level[i], dt_est, dt_pi_ki,
+        dt_pi_kp, iter_tol, dt_chem_cost);
+      if (verbose != 0) {
+        amrex::Print() << "PeleC::compute_new_dt : controlled dt at level "
+                       << i << ": " << dt_min[i] << " (estimate " << dt_est
+                       << ", last " << dt_level[i] << ")" << '\n';
+      }
+    }
+  }
+
   if (fixed_dt <= 0.0) {
     if (post_regrid_flag == 1) {
       // Limit dt's by pre-regrid dt
@@ -1198,13 +1304,14 @@ PeleC::post_timestep(int iteration)
         amrex::MultiFab R_data(
           amrlevel.get_new_data(Reactions_Type).boxArray(),
           amrlevel.get_new_data(Reactions_Type).DistributionMap(),
-          NUM_SPECIES + 2, 1, amrex::MFInfo(), amrlevel.Factory());
+          amrlevel.get_new_data(Reactions_Type).nComp(), 1, amrex::MFInfo(),
+          amrlevel.Factory());
         FillPatch(
           amrlevel, S_data, S_data.nGrow(), cumtime, State_Type, Density, NVAR,
           0);
         FillPatch(
           amrlevel, R_data, R_data.nGrow(), cumtime, Reactions_Type, 0,
-          NUM_SPECIES + 2, 0);
+          R_data.nComp(), 0);
 
         diagMFVec[lev] = std::make_unique<amrex::MultiFab>(
           amrlevel.boxArray(), amrlevel.DistributionMap(), m_diagVars.size(),
@@ -1295,6 +1402,12 @@ PeleC::post_regrid(int lbase, int /*new_finest*/)
 {
   BL_PROFILE("PeleC::post_regrid()");
   fine_mask.clear();
+  react_ws.clear();
+  // Rebuilt from the hydro distribution of the new grids
+  chem_dmap = amrex::DistributionMapping{};
+
+  // Sized again by the first tiles of the new grids
+  pc_reset_scratch_arenas();
 
 #ifdef PELE_USE_SPRAY
   if (lbase == level) {
@@ -2017,12 +2130,34 @@ PeleC::init_reactor()
                    << std::endl;
   }
   reactor->init(1, 1);
+
+  if (chem_hybrid) {
+    reactor_explicit =
+      pele::physics::reactions::ReactorBase::create(chem_hybrid_integrator);
+    reactor_explicit->init(1, 1);
+  }
+
+  if (!chem_coarse_integrator.empty()) {
+    if (chem_isat) {
+      amrex::Abort(
+        "pelec.chem_coarse_integrator is not supported with pelec.chem_isat");
+    }
+    reactor_coarse =
+      pele::physics::reactions::ReactorBase::create(chem_coarse_integrator);
+    reactor_coarse->init(1, 1);
+  }
 }
 
 void
 PeleC::close_reactor()
 {
   reactor->close();
+  if (reactor_explicit) {
+    reactor_explicit->close();
+  }
+  if (reactor_coarse) {
+    reactor_coarse->close();
+  }
 }
 
 void
@@ -2081,15 +2216,15 @@ PeleC::init_filters()
 
   volume.clear();
   volume.define(
-    grids, dmap, 1, numGrow() + nGrowF, amrex::MFInfo(),
+    grids, dmap, 1, numGrowMetrics() + nGrowF, amrex::MFInfo(),
     amrex::FArrayBoxFactory());
   geom.GetVolume(volume);
 
   for (int dir = 0; dir < AMREX_SPACEDIM; dir++) {
     area[dir].clear();
     area[dir].define(
-      getEdgeBoxArray(dir), dmap, 1, numGrow() + nGrowF, amrex::MFInfo(),
-      amrex::FArrayBoxFactory());
+      getEdgeBoxArray(dir), dmap, 1, numGrowMetrics() + nGrowF,
+      amrex::MFInfo(), amrex::FArrayBoxFactory());
     geom.GetFaceArea(area[dir], dir);
   }
 }
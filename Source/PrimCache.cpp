@@ -0,0 +1,104 @@
+#include "Diffusion.H"
+#include "prob.H"
+
+void
+PeleC::fill_stage_state(
+  amrex::MultiFab& S, const int ng, const amrex::Real time)
+{
+  clear_prim_cache();
+  FillPatcherFill(S, 0, NVAR, ng, time, State_Type, 0);
+  if (prim_cache) {
+    build_prim_cache(S, ng, time);
+  }
+}
+
+void
+PeleC::build_prim_cache(
+  const amrex::MultiFab& S, const int ng, const amrex::Real time)
+{
+  BL_PROFILE("PeleC::build_prim_cache()");
+
+  bool need_coeff = do_diffuse;
+#ifdef PELE_USE_SOOT
+  need_coeff = need_coeff || add_soot_src;
+#endif
+  const int nqaux = NQAUX > 0 ? NQAUX : 1;
+  const int nCompTr = dComp_lambda + 1;
+
+  // Redefined only when the grids or the number of ghost cells change
+  const bool same = (prim_q.boxArray() == S.boxArray()) &&
+                    (prim_q.DistributionMap() == S.DistributionMap()) &&
+                    (prim_q.nGrow() >= ng);
+  if (!same) {
+    prim_q.define(S.boxArray(), S.DistributionMap(), QVAR, ng);
+    prim_qaux.define(S.boxArray(), S.DistributionMap(), nqaux, ng);
+    prim_coeff.clear();
+  }
+  if (need_coeff && (!prim_coeff.ok())) {
+    prim_coeff.define(
+      S.boxArray(), S.DistributionMap(), nCompTr, prim_q.nGrow());
+  }
+
+  auto const& sarrs = S.const_arrays();
+  auto const& qarrs = prim_q.arrays();
+  auto const& qauxarrs = prim_qaux.arrays();
+  {
+    BL_PROFILE("PeleC::ctoprim()");
+    amrex::ParallelFor(
+      prim_q, amrex::IntVect(ng),
+      [=] AMREX_GPU_DEVICE(int nbx, int i, int j, int k) noexcept {
+        pc_ctoprim(i, j, k, sarrs[nbx], qarrs[nbx], qauxarrs[nbx]);
+      });
+  }
+
+  // Same coefficients as getMOLSrcTerm
+  if (need_coeff) {
+    BL_PROFILE("PeleC::get_transport_coeffs()");
+    auto const& coeffarrs = prim_coeff.arrays();
+    auto const* ltransparm = trans_parms.device_trans_parm();
+    auto const& geomdata = geom.data();
+    const ProbParmDevice* lprobparm = PeleC::d_prob_parm_device;
+    const bool get_xi = true, get_mu = true, get_lam = true, get_Ddiag = true,
+               get_chi = false;
+    amrex::ParallelFor(
+      prim_q, amrex::IntVect(ng),
+      [=] AMREX_GPU_DEVICE(int nbx, int i, int j, int k) noexcept {
+        auto const& q = qarrs[nbx];
+        auto const& coe = coeffarrs[nbx];
+        amrex::Real muloc, xiloc, lamloc;
+        amrex::Real Ddiag[NUM_SPECIES], Y[NUM_SPECIES] = {0.0};
+        amrex::Real* chi_mix = nullptr;
+        amrex::Real T = q(i, j, k, QTEMP);
+        amrex::Real rho = q(i, j, k, QRHO);
+        for (int n = 0; n < NUM_SPECIES; ++n) {
+          Y[n] = q(i, j, k, QFS + n);
+        }
+
+        const amrex::RealVect x = pc_cmp_loc({AMREX_D_DECL(i, j, k)}, geomdata);
+        pc_transcoeff(
+          get_xi, get_mu, get_lam, get_Ddiag, get_chi, T, rho, Y, Ddiag,
+          chi_mix, muloc, xiloc, lamloc, ltransparm, *lprobparm, x);
+
+        for (int n = 0; n < NUM_SPECIES; ++n) {
+          coe(i, j, k, dComp_rhoD + n) = Ddiag[n];
+        }
+        coe(i, j, k, dComp_mu) = muloc;
+        coe(i, j, k, dComp_xi) = xiloc;
+        coe(i, j, k, dComp_lambda) = lamloc;
+      });
+  }
+
+  prim_cache_src = &S;
+  prim_cache_ng = ng;
+  prim_cache_time = time;
+  prim_cache_coeff = need_coeff;
+}
+
+bool
+PeleC::prim_cached_at(const amrex::Real time, const int ng) const
+{
+  const amrex::Real teps =
+    1.0e-12 * amrex::max<amrex::Real>(1.0, std::abs(prim_cache_time));
+  return (prim_cache_src != nullptr) && (ng <= prim_cache_ng) &&
+         (std::abs(time - prim_cache_time) <= teps);
+}
@@ -1,28 +1,56 @@
+#ifdef AMREX_USE_OMP
+#include <omp.h>
+#endif
+
 #include <AMReX_FArrayBox.H>
+#include <AMReX_Scan.H>
 
 #include "IndexDefines.H"
 #include "PelePhysics.H"
 #include "PeleC.H"
+#include "React.H"
+#include "ChemCache.H"
 
 void
 PeleC::set_typical_values_chem()
 {
   if (use_typical_vals_chem_usr) {
     reactor->set_typ_vals_ode(typical_values_chem_usr);
+    if (reactor_explicit) {
+      reactor_explicit->set_typ_vals_ode(typical_values_chem_usr);
+    }
+    if (reactor_coarse) {
+      reactor_coarse->set_typ_vals_ode(typical_values_chem_usr);
+    }
   } else {
-    const amrex::MultiFab& S_new = get_new_data(State_Type);
-    amrex::Real minTemp = S_new.min(UTEMP);
-    amrex::Real maxTemp = S_new.max(UTEMP);
-    amrex::Vector<amrex::Real> typical_values_chem(NUM_SPECIES + 1, 1e-10);
+    // Extrema of the species densities and temperature in a single pass
+    StateReduction red;
+    for (int sp = 0; sp < NUM_SPECIES; sp++) {
+      red.add(StateReduceItem::Min, StateReduceItem::StateComp, UFS + sp);
+      red.add(StateReduceItem::Max, StateReduceItem::StateComp, UFS + sp);
+    }
+    red.add(StateReduceItem::Min, StateReduceItem::StateComp, UTEMP);
+    red.add(StateReduceItem::Max, StateReduceItem::StateComp, UTEMP);
+    reduceState(red, false);
+    red.reduce();
 
+    amrex::Vector<amrex::Real> typical_values_chem(NUM_SPECIES + 1, 1e-10);
     for (int sp = 0; sp < NUM_SPECIES; sp++) {
-      amrex::Real rhoYs_min = S_new.min(UFS + sp);
-      amrex::Real rhoYs_max = S_new.max(UFS + sp);
+      amrex::Real rhoYs_min = red.value(2 * sp);
+      amrex::Real rhoYs_max = red.value(2 * sp + 1);
       typical_values_chem[sp] = amrex::max<amrex::Real>(
         0.5 * (rhoYs_min + rhoYs_max), typical_rhoY_val_min);
     }
+    amrex::Real minTemp = red.value(2 * NUM_SPECIES);
+    amrex::Real maxTemp = red.value(2 * NUM_SPECIES + 1);
     typical_values_chem[NUM_SPECIES] = 0.5 * (minTemp + maxTemp);
     reactor->set_typ_vals_ode(typical_values_chem);
+    if (reactor_explicit) {
+      reactor_explicit->set_typ_vals_ode(typical_values_chem);
+    }
+    if (reactor_coarse) {
+      reactor_coarse->set_typ_vals_ode(typical_values_chem);
+    }
   }
 }
 
@@ -36,6 +64,8 @@ PeleC::react_state(
   // Update I_R, and recompute S_new
   BL_PROFILE("PeleC::react_state()");
 
+  clear_prim_cache();
+
   const amrex::Real strt_time = amrex::ParallelDescriptor::second();
 
   AMREX_ASSERT(do_react == 1);
@@ -51,77 +81,94 @@ PeleC::react_state(
 
   amrex::MultiFab& S_new = get_new_data(State_Type);
   const int ng = S_new.nGrow();
+  // Integrate the ghost cells too, or only the valid cells and fill the
+  // ghost cells afterwards. Only valid cells are moved to the decoupled
+  // chemistry distribution.
+  const bool use_chem_dmap =
+    chem_dmap_decoupled && (amrex::ParallelDescriptor::NProcs() > 1);
+  const bool valid_only = chem_valid_only || use_chem_dmap;
+  const int ng_react = valid_only ? 0 : ng;
 
-  // Create a MultiFab with all of the non-reacting source terms.
-  amrex::MultiFab non_react_src_tmp;
-  amrex::MultiFab* non_react_src = nullptr;
+  // Work arrays are kept between calls and rebuilt after regridding
+  if (!react_ws.isDefined()) {
+    react_ws.define(grids, dmap, ng, Factory(), valid_only);
+  }
+  amrex::MultiFab& STemp = react_ws.STemp;
+  amrex::MultiFab& extsrc_rY = react_ws.extsrc_rY;
+  amrex::MultiFab& extsrc_rE = react_ws.extsrc_rE;
+  amrex::MultiFab& fctCount = react_ws.fctCount;
+  amrex::MultiFab& failCount = react_ws.failCount;
+  amrex::iMultiFab& dummyMask = react_ws.mask;
 
+  // Gather all of the non-reacting source terms
+  const amrex::MultiFab* non_react_src = &react_ws.non_react_src;
   if (react_init) {
-    non_react_src_tmp.define(grids, dmap, NVAR, ng, amrex::MFInfo(), Factory());
-    non_react_src_tmp.setVal(0);
-    non_react_src = &non_react_src_tmp;
-  } else {
+    react_ws.non_react_src.setVal(0);
+  } else if (aux_src == nullptr) {
     // Only do this if we are not at the first step
-    // Build non-reacting source term, and an S_new that does not include
-    // reactions
-    if (aux_src == nullptr) {
-      non_react_src_tmp.define(
-        grids, dmap, NVAR, ng, amrex::MFInfo(), Factory());
-      non_react_src_tmp.setVal(0);
-      non_react_src = &non_react_src_tmp;
-
-      for (int src : src_list) {
-        amrex::MultiFab::Saxpy(
-          non_react_src_tmp, 0.5, *new_sources[src], 0, 0, NVAR, ng);
-        amrex::MultiFab::Saxpy(
-          non_react_src_tmp, 0.5, *old_sources[src], 0, 0, NVAR, ng);
-      }
+    amrex::MultiFab& non_react_src_tmp = react_ws.non_react_src;
+    non_react_src_tmp.setVal(0);
 
-      if (do_hydro && !do_mol) {
-        amrex::MultiFab::Add(non_react_src_tmp, hydro_source, 0, 0, NVAR, ng);
-      }
-    } else {
-      // in MOL update all non-reacting sources
-      // are passed into auxiliary sources
-      non_react_src = aux_src;
+    for (int src : src_list) {
+      amrex::MultiFab::Saxpy(
+        non_react_src_tmp, 0.5, *new_sources[src], 0, 0, NVAR, ng_react);
+      amrex::MultiFab::Saxpy(
+        non_react_src_tmp, 0.5, *old_sources[src], 0, 0, NVAR, ng_react);
     }
 
-    // S_new = S_old + dt*(non reacting source terms)
-    const amrex::MultiFab& S_old = get_old_data(State_Type);
-    amrex::MultiFab::Copy(S_new, S_old, 0, 0, NVAR, ng);
-    amrex::MultiFab::Saxpy(S_new, dt, *non_react_src, 0, 0, NVAR, ng);
+    if (do_hydro && !do_mol) {
+      amrex::MultiFab::Add(
+        non_react_src_tmp, hydro_source, 0, 0, NVAR, ng_react);
+    }
+  } else {
+    // in MOL update all non-reacting sources
+    // are passed into auxiliary sources
+    non_react_src = aux_src;
   }
 
   amrex::MultiFab& react_src = get_new_data(Reactions_Type);
-  react_src.setVal(0.0);
-
-  // for sundials box integration
-  amrex::MultiFab STemp(grids, dmap, NUM_SPECIES + 2, 0);
-  amrex::MultiFab extsrc_rY(grids, dmap, NUM_SPECIES, 0);
-  amrex::MultiFab extsrc_rE(grids, dmap, 1, 0);
-  amrex::iMultiFab dummyMask(grids, dmap, 1, 0);
-  amrex::MultiFab fctCount(grids, dmap, 1, 0);
-  dummyMask.setVal(1);
-
-  if (!react_init) {
-    const amrex::MultiFab& S_old = get_old_data(State_Type);
-    amrex::MultiFab::Copy(STemp, S_old, UFS, 0, NUM_SPECIES, STemp.nGrow());
-    amrex::MultiFab::Copy(STemp, S_old, UTEMP, NUM_SPECIES, 1, STemp.nGrow());
-    amrex::MultiFab::Copy(
-      STemp, S_old, UEINT, NUM_SPECIES + 1, 1, STemp.nGrow());
-  } else {
-    amrex::MultiFab::Copy(STemp, S_new, UFS, 0, NUM_SPECIES, STemp.nGrow());
-    amrex::MultiFab::Copy(STemp, S_new, UTEMP, NUM_SPECIES, 1, STemp.nGrow());
-    amrex::MultiFab::Copy(
-      STemp, S_new, UEINT, NUM_SPECIES + 1, 1, STemp.nGrow());
-  }
-  amrex::MultiFab::Copy(
-    extsrc_rY, *non_react_src, UFS, 0, NUM_SPECIES, STemp.nGrow());
 
   auto const& fact =
     dynamic_cast<amrex::EBFArrayBoxFactory const&>(S_new.Factory());
   auto const& flags = fact.getMultiEBCellFlagFab();
 
+  ChemActiveParm active_parm;
+  if (chem_compact) {
+    active_parm.temp_min = chem_active_temp;
+    active_parm.heat_release_min = chem_active_heat_release;
+    active_parm.spec_min = chem_active_spec_min;
+    if (!chem_active_spec_name.empty()) {
+      active_parm.spec_idx = find_position(spec_names, chem_active_spec_name);
+      if (active_parm.spec_idx < 0) {
+        amrex::Abort("Unknown species identified as chem_active_spec_name");
+      }
+    }
+  }
+  const bool compact = chem_compact;
+  const bool hybrid = chem_hybrid;
+  const amrex::Real stiffness_max = chem_hybrid_stiffness;
+  dummyMask.setVal(compact ? 0 : 1);
+
+  // only update beyond first step
+  // TODO: Update here? Or just get reaction source?
+  const bool do_update = !react_init;
+
+  // Boxes that are handed to the reactor: those with at least one tile that
+  // is neither covered nor multivalued. The other tiles of these boxes are
+  // flagged with a negative mask in the packing pass and skipped.
+  amrex::Vector<int> box_react(grids.size(), 0);
+  for (amrex::MFIter mfi(S_new, amrex::TilingIfNotGPU()); mfi.isValid();
+       ++mfi) {
+    const amrex::FabType typ =
+      flags[mfi].getType(mfi.growntilebox(ng_react));
+    if (
+      (typ == amrex::FabType::singlevalued) ||
+      (typ == amrex::FabType::regular)) {
+      box_react[mfi.index()] = 1;
+    }
+  }
+
+  // S_new = S_old + dt*(non reacting source terms), and the reactor inputs
 #ifdef AMREX_USE_OMP
 #pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
 #endif
@@ -129,197 +176,361 @@ PeleC::react_state(
     for (amrex::MFIter mfi(S_new, amrex::TilingIfNotGPU()); mfi.isValid();
          ++mfi) {
 
-      const amrex::Box& bx = mfi.growntilebox(ng);
+      const amrex::Box& bx = mfi.growntilebox(ng_react);
 
       // old state or the state at t=0
       auto const& sold_arr =
-        react_init ? S_new.array(mfi) : get_old_data(State_Type).array(mfi);
+        react_init ? S_new.const_array(mfi)
+                   : get_old_data(State_Type).const_array(mfi);
 
       // new state
       auto const& snew_arr = S_new.array(mfi);
-      auto const& nonrs_arr = non_react_src->array(mfi);
-      auto const& I_R = react_src.array(mfi);
-
-      // only update beyond first step
-      // TODO: Update here? Or just get reaction source?
-      const bool do_update = !react_init;
+      auto const& nonrs_arr = non_react_src->const_array(mfi);
+      auto const& I_R = react_src.const_array(mfi);
 
       const auto& flag_fab = flags[mfi];
       amrex::FabType typ = flag_fab.getType(bx);
-      if (typ == amrex::FabType::covered) {
-        if (do_react_load_balance) {
-          const amrex::Box vbox = mfi.tilebox();
-          get_new_data(Work_Estimate_Type)[mfi].plus<amrex::RunOn::Device>(
-            0.0, vbox);
-        }
+      const bool reactable =
+        (typ == amrex::FabType::singlevalued) ||
+        (typ == amrex::FabType::regular);
+
+      auto const& rhoY = STemp.array(mfi);
+      auto const& frcExt = extsrc_rY.array(mfi);
+      auto const& frcEExt = extsrc_rE.array(mfi);
+      auto const& mask = dummyMask.array(mfi);
+      auto const& fc = fctCount.array(mfi);
+      auto const& nfail = failCount.array(mfi);
+      auto const& flag_arr = flag_fab.const_array();
+
+      amrex::ParallelFor(
+        bx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
+          if (do_update) {
+            for (int n = 0; n < NVAR; n++) {
+              snew_arr(i, j, k, n) =
+                sold_arr(i, j, k, n) + dt * nonrs_arr(i, j, k, n);
+            }
+          }
+
+          if (!reactable) {
+            mask(i, j, k) = -1;
+            fc(i, j, k) = 0.0;
+            nfail(i, j, k) = 0.0;
+            return;
+          }
+
+          for (int nsp = 0; nsp < NUM_SPECIES; nsp++) {
+            rhoY(i, j, k, nsp) = sold_arr(i, j, k, UFS + nsp);
+            frcExt(i, j, k, nsp) = nonrs_arr(i, j, k, UFS + nsp);
+          }
+          rhoY(i, j, k, NUM_SPECIES) = sold_arr(i, j, k, UTEMP);
+          rhoY(i, j, k, NUM_SPECIES + 1) = sold_arr(i, j, k, UEINT);
+
+          fc(i, j, k) = 0.0;
+          nfail(i, j, k) = 0.0;
+
+          // work on old state
+          amrex::Real rhou = sold_arr(i, j, k, UMX);
+          amrex::Real rhov = sold_arr(i, j, k, UMY);
+          amrex::Real rhow = sold_arr(i, j, k, UMZ);
+          amrex::Real rho_old = sold_arr(i, j, k, URHO);
+          amrex::Real rhoInv = 1.0 / rho_old;
+
+          amrex::Real e_old =
+            (sold_arr(i, j, k, UEDEN) // total energy
+             - 0.5 * (rhou * rhou + rhov * rhov + rhow * rhow) * rhoInv) // KE
+            * rhoInv;
+
+          // work on new state
+          rhou = snew_arr(i, j, k, UMX);
+          rhov = snew_arr(i, j, k, UMY);
+          rhow = snew_arr(i, j, k, UMZ);
+          rhoInv = 1.0 / snew_arr(i, j, k, URHO);
+
+          amrex::Real rhoedot_ext =
+            (snew_arr(i, j, k, UEDEN) // new total energy
+             - 0.5 * (rhou * rhou + rhov * rhov + rhow * rhow) *
+                 rhoInv // new KE
+             - rho_old * e_old) /
+            dt;
+
+          frcEExt(i, j, k) = rhoedot_ext;
+
+          if (compact || hybrid) {
+            const int active =
+              compact
+                ? pc_chem_active(i, j, k, rhoY, I_R, flag_arr, active_parm)
+                : 1;
+            // stiffness of the old state, which does not depend on the
+            // integrator that took the last step
+            const int cls =
+              (hybrid && (active != 0))
+                ? static_cast<int>(
+                    pc_chem_stiffness(i, j, k, rhoY, dt) > stiffness_max)
+                : 0;
+            mask(i, j, k) = (active != 0) ? 1 + cls : 0;
+          }
+        });
+    }
+  }
+
+  // Measured wall time of the chemistry integration of each box
+  amrex::Vector<amrex::Real> box_cost(grids.size(), 0.0);
+  amrex::Real chem_time = amrex::ParallelDescriptor::second();
+
+  if (use_chem_dmap) {
+    // Integrate the valid cells on a chemistry-only distribution, balanced
+    // with the measured chemistry cost, and bring the result back. The ghost
+    // cells are filled after the unpacking, as with chem_valid_only.
+    if (chem_dmap.size() != grids.size()) {
+      chem_dmap = dmap;
+    }
+    amrex::ParallelDescriptor::ReduceIntMax(
+      box_react.data(), static_cast<int>(box_react.size()));
+
+    amrex::MultiFab STemp_c(grids, chem_dmap, NUM_SPECIES + 2, 0);
+    amrex::MultiFab extsrc_rY_c(grids, chem_dmap, NUM_SPECIES, 0);
+    amrex::MultiFab extsrc_rE_c(grids, chem_dmap, 1, 0);
+    amrex::iMultiFab mask_c(grids, chem_dmap, 1, 0);
+    amrex::MultiFab fctCount_c(grids, chem_dmap, 1, 0);
+    fctCount_c.setVal(0.0);
+    amrex::MultiFab failCount_c(grids, chem_dmap, 1, 0);
+    failCount_c.setVal(0.0);
+    STemp_c.ParallelCopy(STemp, 0, 0, NUM_SPECIES + 2);
+    extsrc_rY_c.ParallelCopy(extsrc_rY, 0, 0, NUM_SPECIES);
+    extsrc_rE_c.ParallelCopy(extsrc_rE, 0, 0, 1);
+    mask_c.ParallelCopy(dummyMask, 0, 0, 1);
+
+    react_integrate(
+      STemp_c, extsrc_rY_c, extsrc_rE_c, mask_c, fctCount_c, failCount_c,
+      box_react, box_cost, dt, 0);
+    chem_time = amrex::ParallelDescriptor::second() - chem_time;
+
+    STemp.ParallelCopy(STemp_c, 0, 0, NUM_SPECIES + 2);
+    fctCount.ParallelCopy(fctCount_c, 0, 0, 1);
+    failCount.ParallelCopy(failCount_c, 0, 0, 1);
+
+    // The cost of each box, measured on whichever rank integrated it
+    amrex::ParallelDescriptor::ReduceRealSum(
+      box_cost.data(), static_cast<int>(box_cost.size()));
+    rebalance_chem_dmap(box_cost);
+  } else {
+    react_integrate(
+      STemp, extsrc_rY, extsrc_rE, dummyMask, fctCount, failCount, box_react,
+      box_cost, dt, ng_react);
+    chem_time = amrex::ParallelDescriptor::second() - chem_time;
+  }
+
+  // The chemistry cost of each box is part of its work estimate
+  if (do_react_load_balance) {
+    amrex::MultiFab& work_est = get_new_data(Work_Estimate_Type);
+    for (amrex::MFIter mfi(work_est, false); mfi.isValid(); ++mfi) {
+      const amrex::Box vbox = mfi.validbox();
+      work_est[mfi].plus<amrex::RunOn::Device>(
+        box_cost[mfi.index()] / vbox.d_numPts(), vbox);
+    }
+  }
+
+  // Reactor effort of the step, for the step size controller: the mean RHS
+  // evaluation count of the cells the reactor integrated
+  if (dt_controller && (dt_chem_cost > 0.0) && !react_init) {
+    auto const& fcs = fctCount.const_arrays();
+    amrex::ReduceOps<amrex::ReduceOpSum, amrex::ReduceOpSum> reduce_op;
+    amrex::ReduceData<amrex::Real, amrex::Real> reduce_data(reduce_op);
+    using ReduceTuple = typename decltype(reduce_data)::Type;
+    reduce_op.eval(
+      fctCount, amrex::IntVect(0), reduce_data,
+      [=] AMREX_GPU_DEVICE(int nbx, int i, int j, int k) noexcept
+      -> ReduceTuple {
+        const amrex::Real nfct = fcs[nbx](i, j, k);
+        return {nfct, (nfct > 0.0) ? 1.0 : 0.0};
+      });
+    ReduceTuple hv = reduce_data.value(reduce_op);
+    amrex::Real sums[2] = {amrex::get<0>(hv), amrex::get<1>(hv)};
+    amrex::ParallelDescriptor::ReduceRealSum(sums, 2);
+    if (sums[1] > 0.0) {
+      DtControl& ctrl = level_dt_control();
+      ctrl.chem_cost = amrex::max(ctrl.chem_cost, sums[0] / sums[1]);
+    }
+  }
+
+  // Cost of a reactor RHS evaluation in each box, to apportion the measured
+  // box cost to its cells
+  const bool telemetry = chem_telemetry;
+  const int tcomp = chemTelemetryComp();
+  amrex::Vector<amrex::Real> box_fct_cost(grids.size(), 0.0);
+  if (telemetry) {
+    for (amrex::MFIter mfi(fctCount, false); mfi.isValid(); ++mfi) {
+      if (box_react[mfi.index()] == 0) {
         continue;
       }
-      if (
-        (typ == amrex::FabType::singlevalued) ||
-        (typ == amrex::FabType::regular)) {
-        amrex::Real wt =
-          amrex::ParallelDescriptor::second(); // timing for each fab
-
-        amrex::Real current_time = 0.0;
-
-        auto const& rhoY = STemp.array(mfi);
-        auto const& T = STemp.array(mfi, NUM_SPECIES);
-        auto const& rhoE = STemp.array(mfi, NUM_SPECIES + 1);
-        auto const& frcExt = extsrc_rY.array(mfi);
-        auto const& frcEExt = extsrc_rE.array(mfi);
-        auto const& mask = dummyMask.array(mfi);
-        auto const& fc = fctCount.array(mfi);
-
-        amrex::ParallelFor(
-          bx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
-            // work on old state
-            amrex::Real rhou = sold_arr(i, j, k, UMX);
-            amrex::Real rhov = sold_arr(i, j, k, UMY);
-            amrex::Real rhow = sold_arr(i, j, k, UMZ);
-            amrex::Real rho_old = sold_arr(i, j, k, URHO);
-            amrex::Real rhoInv = 1.0 / rho_old;
-
-            amrex::Real e_old =
-              (sold_arr(i, j, k, UEDEN) // total energy
-               - 0.5 * (rhou * rhou + rhov * rhov + rhow * rhow) * rhoInv) // KE
-              * rhoInv;
-
-            // work on new state
-            rhou = snew_arr(i, j, k, UMX);
-            rhov = snew_arr(i, j, k, UMY);
-            rhow = snew_arr(i, j, k, UMZ);
-            rhoInv = 1.0 / snew_arr(i, j, k, URHO);
-
-            amrex::Real rhoedot_ext =
-              (snew_arr(i, j, k, UEDEN) // new total energy
-               - 0.5 * (rhou * rhou + rhov * rhov + rhow * rhow) *
-                   rhoInv // new KE
-               - rho_old * e_old) /
-              dt;
-
-            frcEExt(i, j, k) = rhoedot_ext;
-          });
-
-        reactor->react(
-          bx, rhoY, frcExt, T, rhoE, frcEExt, fc, mask, dt, current_time
-#ifdef AMREX_USE_GPU
-          ,
-          amrex::Gpu::gpuStream()
+      auto const& fc = fctCount.const_array(mfi);
+      amrex::ReduceOps<amrex::ReduceOpSum> reduce_op;
+      amrex::ReduceData<amrex::Real> reduce_data(reduce_op);
+      using ReduceTuple = typename decltype(reduce_data)::Type;
+      reduce_op.eval(
+        mfi.growntilebox(ng_react), reduce_data,
+        [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept -> ReduceTuple {
+          return {fc(i, j, k)};
+        });
+      const amrex::Real nfct = amrex::get<0>(reduce_data.value(reduce_op));
+      if (nfct > 0.0) {
+        box_fct_cost[mfi.index()] = box_cost[mfi.index()] / nfct;
+      }
+    }
+  }
+
+  // Unpack the reactor output into S_new, and compute I_R and the heat
+  // release in the same pass
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
 #endif
-        );
-
-        amrex::Gpu::Device::streamSynchronize();
-
-        // unpack data
-        amrex::ParallelFor(
-          bx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
-            // work on old state
-            amrex::Real rhou = sold_arr(i, j, k, UMX);
-            amrex::Real rhov = sold_arr(i, j, k, UMY);
-            amrex::Real rhow = sold_arr(i, j, k, UMZ);
-            amrex::Real rho_old = sold_arr(i, j, k, URHO);
-            amrex::Real rhoInv = 1.0 / rho_old;
-
-            amrex::Real e_old =
-              (sold_arr(i, j, k, UEDEN) // old total energy
-               - 0.5 * (rhou * rhou + rhov * rhov + rhow * rhow) * rhoInv) // KE
-              * rhoInv;
-
-            rhou = snew_arr(i, j, k, UMX);
-            rhov = snew_arr(i, j, k, UMY);
-            rhow = snew_arr(i, j, k, UMZ);
-            rhoInv = 1.0 / snew_arr(i, j, k, URHO);
-
-            amrex::Real rhoedot_ext =
-              (snew_arr(i, j, k, UEDEN) // new total energy
-               - 0.5 * (rhou * rhou + rhov * rhov + rhow * rhow) * rhoInv // KE
-               - rho_old * e_old) // old internal energy
-              / dt;
-
-            amrex::Real umnew =
-              sold_arr(i, j, k, UMX) + dt * nonrs_arr(i, j, k, UMX);
-            amrex::Real vmnew =
-              sold_arr(i, j, k, UMY) + dt * nonrs_arr(i, j, k, UMY);
-            amrex::Real wmnew =
-              sold_arr(i, j, k, UMZ) + dt * nonrs_arr(i, j, k, UMZ);
-
-            // get new rho
-            amrex::Real rhonew = 0.0;
+  {
+    for (amrex::MFIter mfi(S_new, amrex::TilingIfNotGPU()); mfi.isValid();
+         ++mfi) {
 
-            for (int nsp = 0; nsp < NUM_SPECIES; nsp++) {
-              rhonew += rhoY(i, j, k, nsp);
-            }
+      const amrex::Box& bx = mfi.growntilebox(ng_react);
 
-            if (do_update) {
-              snew_arr(i, j, k, URHO) = rhonew;
-              snew_arr(i, j, k, UMX) = umnew;
-              snew_arr(i, j, k, UMY) = vmnew;
-              snew_arr(i, j, k, UMZ) = wmnew;
+      const auto& flag_fab = flags[mfi];
+      amrex::FabType typ = flag_fab.getType(bx);
+      const bool reactable =
+        (typ == amrex::FabType::singlevalued) ||
+        (typ == amrex::FabType::regular);
 
-              for (int nsp = 0; nsp < NUM_SPECIES; nsp++) {
-                snew_arr(i, j, k, UFS + nsp) = rhoY(i, j, k, nsp);
-              }
-              snew_arr(i, j, k, UTEMP) = T(i, j, k);
+      // old state or the state at t=0
+      auto const& sold_arr =
+        react_init ? S_new.const_array(mfi)
+                   : get_old_data(State_Type).const_array(mfi);
 
-              snew_arr(i, j, k, UEINT) = rho_old * e_old + dt * rhoedot_ext;
-              snew_arr(i, j, k, UEDEN) =
-                snew_arr(i, j, k, UEINT) +
-                0.5 * (umnew * umnew + vmnew * vmnew + wmnew * wmnew) / rhonew;
-            }
+      // new state
+      auto const& snew_arr = S_new.array(mfi);
+      auto const& nonrs_arr = non_react_src->const_array(mfi);
+      auto const& I_R = react_src.array(mfi);
 
-            for (int nsp = 0; nsp < NUM_SPECIES; nsp++) {
-              I_R(i, j, k, nsp) = (rhoY(i, j, k, nsp)              // new rhoy
-                                   - sold_arr(i, j, k, UFS + nsp)) // old rhoy
-                                    / dt -
-                                  nonrs_arr(i, j, k, UFS + nsp);
+      auto const& rhoY = STemp.const_array(mfi);
+      auto const& T = STemp.const_array(mfi, NUM_SPECIES);
+      auto const& frcEExt = extsrc_rE.const_array(mfi);
+      auto const& fc = fctCount.const_array(mfi);
+      auto const& nfail = failCount.const_array(mfi);
+      const amrex::Real fct_cost = box_fct_cost[mfi.index()];
+
+      amrex::ParallelFor(
+        bx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
+          if (!reactable) {
+            for (int n = 0; n < NUM_SPECIES + 2; n++) {
+              I_R(i, j, k, n) = 0.0;
             }
+            if (telemetry) {
+              for (int n = 0; n < RCHEM_NTELEMETRY; n++) {
+                I_R(i, j, k, tcomp + n) = 0.0;
+              }
+            }
+            return;
+          }
 
-            I_R(i, j, k, NUM_SPECIES) =
-              (rho_old * e_old + dt * rhoedot_ext // new internal energy
-               + 0.5 * (umnew * umnew + vmnew * vmnew + wmnew * wmnew) /
-                   rhonew                  // new KE
-               - sold_arr(i, j, k, UEDEN)) // old total energy
-                / dt -
-              nonrs_arr(i, j, k, UEDEN);
-          });
-
-        wt = (amrex::ParallelDescriptor::second() - wt) / bx.d_numPts();
-
-        if (do_react_load_balance) {
-          const amrex::Box vbox = mfi.tilebox();
-          get_new_data(Work_Estimate_Type)[mfi].plus<amrex::RunOn::Device>(
-            wt, vbox);
-        }
+          // work on old state
+          amrex::Real rhou = sold_arr(i, j, k, UMX);
+          amrex::Real rhov = sold_arr(i, j, k, UMY);
+          amrex::Real rhow = sold_arr(i, j, k, UMZ);
+          amrex::Real rho_old = sold_arr(i, j, k, URHO);
+          amrex::Real rhoInv = 1.0 / rho_old;
 
-        // update heat release
-        amrex::ParallelFor(
-          bx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
-            I_R(i, j, k, NUM_SPECIES + 1) = 0.0;
-            auto eos = pele::physics::PhysicsType::eos();
+          amrex::Real e_old =
+            (sold_arr(i, j, k, UEDEN) // old total energy
+             - 0.5 * (rhou * rhou + rhov * rhov + rhow * rhow) * rhoInv) // KE
+            * rhoInv;
 
-            amrex::Real hi[NUM_SPECIES] = {0.0};
+          // computed in the packing pass
+          const amrex::Real rhoedot_ext = frcEExt(i, j, k);
 
-            amrex::Real Yspec[NUM_SPECIES] = {0.0};
-            for (int nsp = 0; nsp < NUM_SPECIES; nsp++) {
-              Yspec[nsp] =
-                snew_arr(i, j, k, UFS + nsp) / snew_arr(i, j, k, URHO);
-            }
-            eos.RTY2Hi(
-              snew_arr(i, j, k, URHO), snew_arr(i, j, k, UTEMP), Yspec, hi);
+          amrex::Real umnew =
+            sold_arr(i, j, k, UMX) + dt * nonrs_arr(i, j, k, UMX);
+          amrex::Real vmnew =
+            sold_arr(i, j, k, UMY) + dt * nonrs_arr(i, j, k, UMY);
+          amrex::Real wmnew =
+            sold_arr(i, j, k, UMZ) + dt * nonrs_arr(i, j, k, UMZ);
+
+          // get new rho
+          amrex::Real rhonew = 0.0;
+
+          for (int nsp = 0; nsp < NUM_SPECIES; nsp++) {
+            rhonew += rhoY(i, j, k, nsp);
+          }
+
+          if (do_update) {
+            snew_arr(i, j, k, URHO) = rhonew;
+            snew_arr(i, j, k, UMX) = umnew;
+            snew_arr(i, j, k, UMY) = vmnew;
+            snew_arr(i, j, k, UMZ) = wmnew;
 
             for (int nsp = 0; nsp < NUM_SPECIES; nsp++) {
-              I_R(i, j, k, NUM_SPECIES + 1) -= hi[nsp] * I_R(i, j, k, nsp);
+              snew_arr(i, j, k, UFS + nsp) = rhoY(i, j, k, nsp);
             }
-          });
-      }
+            snew_arr(i, j, k, UTEMP) = T(i, j, k);
+
+            snew_arr(i, j, k, UEINT) = rho_old * e_old + dt * rhoedot_ext;
+            snew_arr(i, j, k, UEDEN) =
+              snew_arr(i, j, k, UEINT) +
+              0.5 * (umnew * umnew + vmnew * vmnew + wmnew * wmnew) / rhonew;
+          }
+
+          for (int nsp = 0; nsp < NUM_SPECIES; nsp++) {
+            I_R(i, j, k, nsp) = (rhoY(i, j, k, nsp)              // new rhoy
+                                 - sold_arr(i, j, k, UFS + nsp)) // old rhoy
+                                  / dt -
+                                nonrs_arr(i, j, k, UFS + nsp);
+          }
+
+          I_R(i, j, k, NUM_SPECIES) =
+            (rho_old * e_old + dt * rhoedot_ext // new internal energy
+             + 0.5 * (umnew * umnew + vmnew * vmnew + wmnew * wmnew) /
+                 rhonew                  // new KE
+             - sold_arr(i, j, k, UEDEN)) // old total energy
+              / dt -
+            nonrs_arr(i, j, k, UEDEN);
+
+          // heat release
+          auto eos = pele::physics::PhysicsType::eos();
+
+          amrex::Real hi[NUM_SPECIES] = {0.0};
+
+          const amrex::Real rho = snew_arr(i, j, k, URHO);
+          amrex::Real Yspec[NUM_SPECIES] = {0.0};
+          for (int nsp = 0; nsp < NUM_SPECIES; nsp++) {
+            Yspec[nsp] = snew_arr(i, j, k, UFS + nsp) / rho;
+          }
+          eos.RTY2Hi(rho, snew_arr(i, j, k, UTEMP), Yspec, hi);
+
+          amrex::Real hrr = 0.0;
+          for (int nsp = 0; nsp < NUM_SPECIES; nsp++) {
+            hrr -= hi[nsp] * I_R(i, j, k, nsp);
+          }
+          I_R(i, j, k, NUM_SPECIES + 1) = hrr;
+
+          if (telemetry) {
+            I_R(i, j, k, tcomp) = fc(i, j, k);
+            I_R(i, j, k, tcomp + 1) = nfail(i, j, k);
+            I_R(i, j, k, tcomp + 2) = fct_cost * fc(i, j, k);
+          }
+        });
     }
   }
 
   if (ng > 0) {
-    S_new.FillBoundary(geom.periodicity());
+    if (valid_only) {
+      // Exchange the ghost cells, including the physical and coarse-fine
+      // boundaries that are not integrated
+      amrex::MultiFab& S_fill = react_ws.S_fill;
+      FillPatch(
+        *this, S_fill, ng, state[State_Type].curTime(), State_Type, 0, NVAR);
+      amrex::MultiFab::Copy(S_new, S_fill, 0, 0, NVAR, ng);
+    } else {
+      S_new.FillBoundary(geom.periodicity());
+    }
   }
 
   if (verbose > 1) {
+    print_chem_telemetry(fctCount, failCount, box_react, chem_time, ng_react);
+
     const int IOProc = amrex::ParallelDescriptor::IOProcessorNumber();
     amrex::Real run_time = amrex::ParallelDescriptor::second() - strt_time;
 
@@ -330,3 +541,698 @@ PeleC::react_state(
     }
   }
 }
+
+void
+PeleC::react_integrate(
+  amrex::MultiFab& STemp,
+  amrex::MultiFab& extsrc_rY,
+  amrex::MultiFab& extsrc_rE,
+  amrex::iMultiFab& mask,
+  amrex::MultiFab& fctCount,
+  amrex::MultiFab& failCount,
+  const amrex::Vector<int>& box_react,
+  amrex::Vector<amrex::Real>& box_cost,
+  amrex::Real dt,
+  int ng)
+{
+  // Integrate the reactor inputs in place, on whichever distribution they
+  // live, and accumulate the wall time spent on each box in box_cost
+  BL_PROFILE("PeleC::react_integrate()");
+
+  if (chem_compact || chem_isat || chem_hybrid) {
+    react_compacted(
+      STemp, extsrc_rY, extsrc_rE, mask, fctCount, failCount, box_react,
+      box_cost, dt, ng);
+    return;
+  }
+
+#ifdef AMREX_USE_OMP
+#pragma omp parallel if (amrex::Gpu::notInLaunchRegion())
+#endif
+  {
+    for (amrex::MFIter mfi(STemp, amrex::TilingIfNotGPU()); mfi.isValid();
+         ++mfi) {
+      if (box_react[mfi.index()] == 0) {
+        continue;
+      }
+#ifndef AMREX_USE_GPU
+      // tiles of a reacting box that are not reactable themselves
+      if (mask[mfi](mfi.tilebox().smallEnd()) < 0) {
+        continue;
+      }
+#endif
+
+      const amrex::Box& bx = mfi.growntilebox(ng);
+      amrex::Real wt = amrex::ParallelDescriptor::second();
+
+      amrex::Real current_time = 0.0;
+      amrex::Real dt_react = dt;
+
+      auto const& rhoY = STemp.array(mfi);
+      auto const& T = STemp.array(mfi, NUM_SPECIES);
+      auto const& rhoE = STemp.array(mfi, NUM_SPECIES + 1);
+      auto const& frcExt = extsrc_rY.array(mfi);
+      auto const& frcEExt = extsrc_rE.array(mfi);
+      auto const& m = mask.array(mfi);
+      auto const& fc = fctCount.array(mfi);
+      auto const& nfail = failCount.array(mfi);
+
+      const int status = reactor->react(
+        bx, rhoY, frcExt, T, rhoE, frcEExt, fc, m, dt_react, current_time
+#ifdef AMREX_USE_GPU
+        ,
+        amrex::Gpu::gpuStream()
+#endif
+      );
+      if (status < 0) {
+        pc_chem_count_failed(bx, nfail);
+      }
+
+      amrex::Gpu::Device::streamSynchronize();
+
+      wt = amrex::ParallelDescriptor::second() - wt;
+      amrex::HostDevice::Atomic::Add(&box_cost[mfi.index()], wt);
+    }
+  }
+}
+
+void
+PeleC::react_compacted(
+  amrex::MultiFab& STemp,
+  const amrex::MultiFab& extsrc_rY,
+  const amrex::MultiFab& extsrc_rE,
+  const amrex::iMultiFab& mask,
+  amrex::MultiFab& fctCount,
+  amrex::MultiFab& failCount,
+  const amrex::Vector<int>& box_react,
+  amrex::Vector<amrex::Real>& box_cost,
+  amrex::Real dt,
+  int ng)
+{
+  // Integrate only the chemically active cells (mask > 0). They are gathered
+  // from all the tiles of this rank into a single 1D batch, integrated, and
+  // scattered back into STemp. Inactive cells only see the non-reacting
+  // sources, and their temperature is recomputed from the updated state.
+  // Active cells are ordered by mask value, which holds 1 + the stiffness
+  // class with chem_hybrid.
+  BL_PROFILE("PeleC::react_compacted()");
+
+  const int nclass = chem_hybrid ? CHEM_NCLASS : 1;
+
+  amrex::ReduceOps<amrex::ReduceOpSum> reduce_op;
+  amrex::ReduceData<int> reduce_data(reduce_op);
+  using ReduceTuple = typename decltype(reduce_data)::Type;
+  for (amrex::MFIter mfi(STemp, amrex::TilingIfNotGPU()); mfi.isValid();
+       ++mfi) {
+    if (box_react[mfi.index()] == 0) {
+      continue;
+    }
+    const amrex::Box bx = mfi.growntilebox(ng);
+    auto const& m = mask.const_array(mfi);
+    reduce_op.eval(
+      bx, reduce_data,
+      [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept -> ReduceTuple {
+        return {static_cast<int>(m(i, j, k) > 0)};
+      });
+  }
+  ReduceTuple hv = reduce_data.value(reduce_op);
+  const int nactive = amrex::get<0>(hv);
+
+  const amrex::Box batch_box(
+    amrex::IntVect::TheZeroVector(),
+    amrex::IntVect(AMREX_D_DECL(amrex::max<int>(nactive, 1) - 1, 0, 0)));
+
+  amrex::FArrayBox batch_state(
+    batch_box, NUM_SPECIES + 2, amrex::The_Async_Arena());
+  amrex::FArrayBox batch_src(
+    batch_box, NUM_SPECIES + 1, amrex::The_Async_Arena());
+  amrex::FArrayBox batch_fc(batch_box, 1, amrex::The_Async_Arena());
+  amrex::FArrayBox batch_fail(batch_box, 1, amrex::The_Async_Arena());
+  batch_fail.setVal<amrex::RunOn::Device>(0.0);
+  amrex::Gpu::DeviceVector<int> cell_ids(amrex::max<int>(nactive, 1));
+
+  struct ChemTile
+  {
+    int gid;
+    int first;
+    int nact;
+    amrex::Box bx;
+  };
+  amrex::Vector<ChemTile> tiles;
+
+  // Pack the active cells, one class after the other, and apply the
+  // non-reacting update to the others
+  amrex::Long ntotal = 0;
+  int offset = 0;
+  int nexplicit = 0;
+  for (int cls = 0; cls < nclass; cls++) {
+    if (cls == 1) {
+      nexplicit = offset;
+    }
+    for (amrex::MFIter mfi(STemp, amrex::TilingIfNotGPU()); mfi.isValid();
+         ++mfi) {
+      if (box_react[mfi.index()] == 0) {
+        continue;
+      }
+
+      const amrex::Box bx = mfi.growntilebox(ng);
+
+      auto const& rhoY = STemp.array(mfi);
+      auto const& frcExt = extsrc_rY.const_array(mfi);
+      auto const& frcEExt = extsrc_rE.const_array(mfi);
+      auto const& m = mask.const_array(mfi);
+      auto const& bstate = batch_state.array();
+      auto const& bsrc = batch_src.array();
+      int* ids = cell_ids.data();
+      const int first = offset;
+      const int npts = static_cast<int>(bx.numPts());
+      const int key = 1 + cls;
+      const bool update_inactive = (cls == 0);
+
+      const int nact = amrex::Scan::PrefixSum<int>(
+        npts,
+        [=] AMREX_GPU_DEVICE(int n) -> int {
+          return static_cast<int>(m(bx.atOffset(n)) == key);
+        },
+        [=] AMREX_GPU_DEVICE(int n, int ps) {
+          const amrex::IntVect iv = bx.atOffset(n);
+          if (m(iv) == key) {
+            const amrex::IntVect ib(AMREX_D_DECL(first + ps, 0, 0));
+            ids[first + ps] = n;
+            for (int c = 0; c < NUM_SPECIES + 2; c++) {
+              bstate(ib, c) = rhoY(iv, c);
+            }
+            for (int c = 0; c < NUM_SPECIES; c++) {
+              bsrc(ib, c) = frcExt(iv, c);
+            }
+            bsrc(ib, NUM_SPECIES) = frcEExt(iv);
+          } else if (update_inactive && (m(iv) == 0)) {
+            for (int c = 0; c < NUM_SPECIES; c++) {
+              rhoY(iv, c) += dt * frcExt(iv, c);
+            }
+            rhoY(iv, NUM_SPECIES + 1) += dt * frcEExt(iv);
+
+            // temperature consistent with the updated state
+            amrex::Real rho = 0.0;
+            for (int c = 0; c < NUM_SPECIES; c++) {
+              rho += rhoY(iv, c);
+            }
+            const amrex::Real rhoInv = 1.0 / rho;
+            amrex::Real Y[NUM_SPECIES] = {0.0};
+            for (int c = 0; c < NUM_SPECIES; c++) {
+              Y[c] = rhoY(iv, c) * rhoInv;
+            }
+            amrex::Real T = rhoY(iv, NUM_SPECIES);
+            auto eos = pele::physics::PhysicsType::eos();
+            eos.REY2T(rho, rhoY(iv, NUM_SPECIES + 1) * rhoInv, Y, T);
+            rhoY(iv, NUM_SPECIES) = T;
+          }
+        },
+        amrex::Scan::Type::exclusive, amrex::Scan::retSum);
+
+      tiles.push_back({mfi.index(), first, nact, bx});
+      offset += nact;
+      if (update_inactive) {
+        ntotal += npts;
+      }
+    }
+  }
+  AMREX_ASSERT(offset == nactive);
+
+  // Integrate the batch: the non-stiff part explicitly, the rest with the
+  // main integrator
+  amrex::Real wt = amrex::ParallelDescriptor::second();
+  if (nexplicit > 0) {
+    react_batch(
+      *reactor_explicit, batch_state, batch_src, batch_fc, batch_fail, 0,
+      nexplicit, dt);
+  }
+  const int nimplicit = nactive - nexplicit;
+  if (nimplicit > 0) {
+    if (chem_isat) {
+      react_cached(
+        batch_state, batch_src, batch_fc, batch_fail, nexplicit, nimplicit,
+        dt);
+    } else {
+      react_batch(
+        *reactor, batch_state, batch_src, batch_fc, batch_fail, nexplicit,
+        nimplicit, dt);
+    }
+  }
+  wt = amrex::ParallelDescriptor::second() - wt;
+
+  // Scatter the integrated cells back
+  for (const auto& tile : tiles) {
+    if (nactive > 0) {
+      box_cost[tile.gid] += wt * static_cast<amrex::Real>(tile.nact) / nactive;
+    }
+
+    if (tile.nact == 0) {
+      continue;
+    }
+
+    auto const& rhoY = STemp.array(tile.gid);
+    auto const& fc = fctCount.array(tile.gid);
+    auto const& nfail = failCount.array(tile.gid);
+    auto const& bstate = batch_state.const_array();
+    auto const& bfc = batch_fc.const_array();
+    auto const& bfail = batch_fail.const_array();
+    const int* ids = cell_ids.data();
+    const amrex::Box bx = tile.bx;
+    const int first = tile.first;
+    amrex::ParallelFor(tile.nact, [=] AMREX_GPU_DEVICE(int n) noexcept {
+      const amrex::IntVect iv = bx.atOffset(ids[first + n]);
+      const amrex::IntVect ib(AMREX_D_DECL(first + n, 0, 0));
+      for (int c = 0; c < NUM_SPECIES + 2; c++) {
+        rhoY(iv, c) = bstate(ib, c);
+      }
+      fc(iv) = bfc(ib);
+      nfail(iv) = bfail(ib);
+    });
+  }
+  amrex::Gpu::streamSynchronize();
+
+  if (verbose > 1) {
+    amrex::Long counts[3] = {nactive, ntotal, nexplicit};
+    amrex::ParallelDescriptor::ReduceLongSum(counts, 3);
+    amrex::Print() << "... reacting " << counts[0] << " of " << counts[1]
+                   << " cells" << std::endl;
+    if (chem_hybrid) {
+      amrex::Print() << "... " << counts[2]
+                     << " non-stiff cells integrated with "
+                     << chem_hybrid_integrator << std::endl;
+    }
+
+    if (chem_isat) {
+      amrex::Long isat[6] = {0, 0, 0, 0, 0, 0};
+      if (chem_cache) {
+        const auto& ctr = chem_cache->counters();
+        isat[0] = ctr.query;
+        isat[1] = ctr.hit;
+        isat[2] = ctr.grow;
+        isat[3] = ctr.add;
+        isat[4] = ctr.evict;
+        isat[5] = chem_cache->size();
+        chem_cache->reset_counters();
+      }
+      amrex::ParallelDescriptor::ReduceLongSum(isat, 6);
+      amrex::Print() << "... ISAT queries " << isat[0] << ", hits " << isat[1]
+                     << ", growths " << isat[2] << ", additions " << isat[3]
+                     << ", evictions " << isat[4] << ", records " << isat[5]
+                     << std::endl;
+    }
+  }
+}
+
+void
+PeleC::react_batch(
+  pele::physics::reactions::ReactorBase& rx,
+  amrex::FArrayBox& state,
+  amrex::FArrayBox& src,
+  amrex::FArrayBox& fctCount,
+  amrex::FArrayBox& failCount,
+  int first,
+  int ncells,
+  amrex::Real dt)
+{
+  // Integrate the ncells cells of a 1D batch of reactor inputs starting at
+  // first with reactor rx, one contiguous chunk per thread
+  const amrex::Box bbx = state.box();
+  amrex::IArrayBox mask(bbx, 1, amrex::The_Async_Arena());
+  mask.setVal<amrex::RunOn::Device>(1);
+
+  auto const& rhoY = state.array();
+  auto const& T = state.array(NUM_SPECIES);
+  auto const& rhoE = state.array(NUM_SPECIES + 1);
+  auto const& frcExt = src.array();
+  auto const& frcEExt = src.array(NUM_SPECIES);
+  auto const& fc = fctCount.array();
+  auto const& nfail = failCount.array();
+  auto const& m = mask.array();
+
+  int nchunks = 1;
+#ifdef AMREX_USE_OMP
+  if (amrex::Gpu::notInLaunchRegion()) {
+    nchunks = omp_get_max_threads();
+  }
+#endif
+  if (chem_compact_chunk_size > 0) {
+    nchunks = (ncells + chem_compact_chunk_size - 1) / chem_compact_chunk_size;
+  }
+  nchunks = amrex::min<int>(nchunks, ncells);
+
+#ifdef AMREX_USE_OMP
+#pragma omp parallel for schedule(dynamic, 1) if (amrex::Gpu::notInLaunchRegion())
+#endif
+  for (int ic = 0; ic < nchunks; ic++) {
+    const int lo =
+      first +
+      static_cast<int>((static_cast<amrex::Long>(ncells) * ic) / nchunks);
+    const int hi =
+      first + static_cast<int>(
+                (static_cast<amrex::Long>(ncells) * (ic + 1)) / nchunks - 1);
+    const amrex::Box cbx(
+      amrex::IntVect(AMREX_D_DECL(lo, 0, 0)),
+      amrex::IntVect(AMREX_D_DECL(hi, 0, 0)));
+    amrex::Real dt_react = dt;
+    amrex::Real current_time = 0.0;
+    const int status = rx.react(
+      cbx, rhoY, frcExt, T, rhoE, frcEExt, fc, m, dt_react, current_time
+#ifdef AMREX_USE_GPU
+      ,
+      amrex::Gpu::gpuStream()
+#endif
+    );
+    if (status < 0) {
+      pc_chem_count_failed(cbx, nfail);
+    }
+  }
+  amrex::Gpu::Device::streamSynchronize();
+}
+
+void
+PeleC::react_cached(
+  amrex::FArrayBox& state,
+  amrex::FArrayBox& src,
+  amrex::FArrayBox& fctCount,
+  amrex::FArrayBox& failCount,
+  int first,
+  int ncells,
+  amrex::Real dt)
+{
+  // Integrate the ncells cells of a 1D batch starting at first through the
+  // ISAT cache: retrieve what the cache covers, integrate the rest directly,
+  // then grow or add records for the directly integrated cells. Host only.
+  BL_PROFILE("PeleC::react_cached()");
+
+  constexpr int NX = ChemCache::NX;
+  constexpr int NY = ChemCache::NY;
+  // Relative step of the finite difference sensitivities
+  constexpr amrex::Real fd_eps = 1.0e-6;
+
+  if (!chem_cache) {
+    chem_cache = std::make_unique<ChemCache>(chem_isat_tol, chem_isat_max_mb);
+  }
+
+  auto const& st = state.array();
+  auto const& sr = src.array();
+  auto const& sfc = fctCount.array();
+  auto const& sfail = failCount.array();
+  auto get_input = [&](int n, amrex::Real* x) {
+    const amrex::IntVect iv(AMREX_D_DECL(n, 0, 0));
+    for (int c = 0; c < NUM_SPECIES; c++) {
+      x[c] = st(iv, c);
+      x[NUM_SPECIES + 1 + c] = sr(iv, c);
+    }
+    x[NUM_SPECIES] = st(iv, NUM_SPECIES + 1);
+    x[2 * NUM_SPECIES + 1] = sr(iv, NUM_SPECIES);
+    x[2 * NUM_SPECIES + 2] = dt;
+  };
+  auto set_output = [&](int n, const amrex::Real* y) {
+    const amrex::IntVect iv(AMREX_D_DECL(n, 0, 0));
+    for (int c = 0; c < NUM_SPECIES + 2; c++) {
+      st(iv, c) = y[c];
+    }
+  };
+
+  // Retrieve
+  amrex::Vector<int> miss;
+  amrex::Vector<int> miss_rid;
+  for (int n = first; n < first + ncells; n++) {
+    amrex::Real x[NX];
+    amrex::Real y[NY];
+    int rid = -1;
+    get_input(n, x);
+    if (chem_cache->retrieve(x, y, rid)) {
+      set_output(n, y);
+      sfc(n, 0, 0) = 0.0;
+    } else {
+      miss.push_back(n);
+      miss_rid.push_back(rid);
+    }
+  }
+  const int nmiss = static_cast<int>(miss.size());
+  if (nmiss == 0) {
+    return;
+  }
+
+  // Direct integration of the misses
+  const amrex::Box mbox(
+    amrex::IntVect::TheZeroVector(),
+    amrex::IntVect(AMREX_D_DECL(nmiss - 1, 0, 0)));
+  amrex::FArrayBox mstate(mbox, NUM_SPECIES + 2);
+  amrex::FArrayBox msrc(mbox, NUM_SPECIES + 1);
+  amrex::FArrayBox mfc(mbox, 1);
+  amrex::FArrayBox mfail(mbox, 1);
+  mfail.setVal(0.0);
+  for (int m = 0; m < nmiss; m++) {
+    const amrex::IntVect iv(AMREX_D_DECL(miss[m], 0, 0));
+    const amrex::IntVect im(AMREX_D_DECL(m, 0, 0));
+    for (int c = 0; c < NUM_SPECIES + 2; c++) {
+      mstate(im, c) = st(iv, c);
+    }
+    for (int c = 0; c < NUM_SPECIES + 1; c++) {
+      msrc(im, c) = sr(iv, c);
+    }
+  }
+  react_batch(*reactor, mstate, msrc, mfc, mfail, 0, nmiss, dt);
+
+  // Grow the closest record if it is accurate enough there, otherwise
+  // queue the cell for addition. Failed integrations are not tabulated.
+  amrex::Vector<int> adds;
+  for (int m = 0; m < nmiss; m++) {
+    const amrex::IntVect im(AMREX_D_DECL(m, 0, 0));
+    if (mfail(im) > 0.0) {
+      continue;
+    }
+    amrex::Real x[NX];
+    amrex::Real y[NY];
+    get_input(miss[m], x);
+    for (int c = 0; c < NUM_SPECIES + 2; c++) {
+      y[c] = mstate(im, c);
+    }
+    if (
+      ((miss_rid[m] < 0) || !chem_cache->grow(miss_rid[m], x, y)) &&
+      (static_cast<int>(adds.size()) < chem_isat_max_adds)) {
+      adds.push_back(m);
+    }
+  }
+
+  // Sensitivities of the added records by one sided finite differences:
+  // one perturbed cell per input at dt, and one unperturbed cell at dt + hdt.
+  // The batch is integrated with a single dt, so all records share hdt.
+  const int nadd = static_cast<int>(adds.size());
+  if (nadd > 0) {
+    const amrex::Real hdt = fd_eps * dt;
+    const int nfd = nadd * (NX - 1);
+    amrex::FArrayBox fstate(
+      amrex::Box(
+        amrex::IntVect::TheZeroVector(),
+        amrex::IntVect(AMREX_D_DECL(nfd - 1, 0, 0))),
+      NUM_SPECIES + 2);
+    amrex::FArrayBox fsrc(fstate.box(), NUM_SPECIES + 1);
+    amrex::FArrayBox dstate(
+      amrex::Box(
+        amrex::IntVect::TheZeroVector(),
+        amrex::IntVect(AMREX_D_DECL(nadd - 1, 0, 0))),
+      NUM_SPECIES + 2);
+    amrex::FArrayBox dsrc(dstate.box(), NUM_SPECIES + 1);
+    amrex::Vector<amrex::Real> xadd(nadd * NX);
+    amrex::Vector<amrex::Real> hadd(nadd * NX);
+    for (int a = 0; a < nadd; a++) {
+      const int n = miss[adds[a]];
+      const amrex::IntVect iv(AMREX_D_DECL(n, 0, 0));
+      amrex::Real* x = &xadd[a * NX];
+      amrex::Real* h = &hadd[a * NX];
+      amrex::Real ys[NY];
+      get_input(n, x);
+      ChemCache::scales(x, st(iv, NUM_SPECIES), h, ys);
+      for (int c = 0; c < NX - 1; c++) {
+        h[c] *= fd_eps;
+      }
+      h[NX - 1] = hdt;
+
+      for (int c = 0; c < NX; c++) {
+        auto& fs = (c < NX - 1) ? fstate : dstate;
+        auto& fr = (c < NX - 1) ? fsrc : dsrc;
+        const int f = (c < NX - 1) ? a * (NX - 1) + c : a;
+        const amrex::IntVect ifd(AMREX_D_DECL(f, 0, 0));
+        for (int k = 0; k < NUM_SPECIES + 2; k++) {
+          fs(ifd, k) = st(iv, k);
+        }
+        for (int k = 0; k < NUM_SPECIES + 1; k++) {
+          fr(ifd, k) = sr(iv, k);
+        }
+        if (c < NUM_SPECIES) {
+          fs(ifd, c) += h[c];
+        } else if (c == NUM_SPECIES) {
+          fs(ifd, NUM_SPECIES + 1) += h[c];
+        } else if (c < NX - 1) {
+          fr(ifd, c - NUM_SPECIES - 1) += h[c];
+        }
+      }
+    }
+    amrex::FArrayBox ffc(fstate.box(), 1);
+    amrex::FArrayBox dfc(dstate.box(), 1);
+    amrex::FArrayBox ffail(fstate.box(), 1);
+    amrex::FArrayBox dfail(dstate.box(), 1);
+    ffail.setVal(0.0);
+    dfail.setVal(0.0);
+    react_batch(*reactor, fstate, fsrc, ffc, ffail, 0, nfd, dt);
+    react_batch(*reactor, dstate, dsrc, dfc, dfail, 0, nadd, dt + hdt);
+
+    amrex::Vector<amrex::Real> A(NY * NX);
+    for (int a = 0; a < nadd; a++) {
+      const amrex::IntVect im(AMREX_D_DECL(adds[a], 0, 0));
+      const amrex::Real* x = &xadd[a * NX];
+      const amrex::Real* h = &hadd[a * NX];
+      amrex::Real y[NY];
+      for (int i = 0; i < NY; i++) {
+        y[i] = mstate(im, i);
+      }
+      for (int c = 0; c < NX; c++) {
+        auto const& fs = (c < NX - 1) ? fstate : dstate;
+        const int f = (c < NX - 1) ? a * (NX - 1) + c : a;
+        const amrex::IntVect ifd(AMREX_D_DECL(f, 0, 0));
+        for (int i = 0; i < NY; i++) {
+          A[i * NX + c] = (fs(ifd, i) - y[i]) / h[c];
+        }
+      }
+      chem_cache->add(x, y, A.data());
+    }
+  }
+
+  for (int m = 0; m < nmiss; m++) {
+    const amrex::IntVect im(AMREX_D_DECL(m, 0, 0));
+    amrex::Real y[NY];
+    for (int c = 0; c < NUM_SPECIES + 2; c++) {
+      y[c] = mstate(im, c);
+    }
+    set_output(miss[m], y);
+    sfc(miss[m], 0, 0) = mfc(im);
+    sfail(miss[m], 0, 0) = mfail(im);
+  }
+}
+
+void
+PeleC::rebalance_chem_dmap(const amrex::Vector<amrex::Real>& box_cost)
+{
+  // Redistribute the chemistry boxes when the measured cost of the busiest
+  // rank exceeds the average by more than chem_dmap_imbalance
+  BL_PROFILE("PeleC::rebalance_chem_dmap()");
+
+  const int nprocs = amrex::ParallelDescriptor::NProcs();
+  amrex::Vector<amrex::Real> rank_cost(nprocs, 0.0);
+  for (int i = 0; i < static_cast<int>(box_cost.size()); i++) {
+    rank_cost[chem_dmap[i]] += box_cost[i];
+  }
+
+  amrex::Real max_cost = 0.0;
+  amrex::Real sum_cost = 0.0;
+  for (const auto& c : rank_cost) {
+    max_cost = amrex::max<amrex::Real>(max_cost, c);
+    sum_cost += c;
+  }
+  if (sum_cost <= 0.0) {
+    return;
+  }
+  const amrex::Real imbalance = max_cost * nprocs / sum_cost;
+  if (imbalance <= chem_dmap_imbalance) {
+    return;
+  }
+
+  amrex::Real efficiency = 0.0;
+  amrex::DistributionMapping new_dmap =
+    (chem_dmap_strategy == "sfc")
+      ? amrex::DistributionMapping::makeSFC(box_cost, grids, efficiency)
+      : amrex::DistributionMapping::makeKnapSack(box_cost, efficiency);
+
+  // efficiency is the average over the maximum rank cost
+  const bool accept = efficiency * imbalance > 1.0;
+  if (accept) {
+    chem_dmap = new_dmap;
+  }
+
+  if (verbose > 0) {
+    amrex::Print() << "... chemistry load imbalance " << imbalance
+                   << ", rebalanced efficiency " << efficiency
+                   << (accept ? " (accepted)" : " (rejected)") << std::endl;
+  }
+}
+
+void
+PeleC::print_chem_telemetry(
+  const amrex::MultiFab& fctCount,
+  const amrex::MultiFab& failCount,
+  const amrex::Vector<int>& box_react,
+  amrex::Real chem_time,
+  int ng)
+{
+  // Histogram of the reactor RHS evaluations per cell, failed reactor calls
+  // and spread of the chemistry wall time across ranks
+  BL_PROFILE("PeleC::print_chem_telemetry()");
+
+  amrex::Gpu::DeviceVector<amrex::Long> hist_d(CHEM_FCT_NBINS, 0);
+  amrex::Long* hist = hist_d.data();
+  amrex::ReduceOps<amrex::ReduceOpSum, amrex::ReduceOpSum> reduce_op;
+  amrex::ReduceData<amrex::Long, amrex::Long> reduce_data(reduce_op);
+  using ReduceTuple = typename decltype(reduce_data)::Type;
+  for (amrex::MFIter mfi(fctCount, false); mfi.isValid(); ++mfi) {
+    if (box_react[mfi.index()] == 0) {
+      continue;
+    }
+    const amrex::Box bx = mfi.growntilebox(ng);
+    auto const& fc = fctCount.const_array(mfi);
+    auto const& nfail = failCount.const_array(mfi);
+    reduce_op.eval(
+      bx, reduce_data,
+      [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept -> ReduceTuple {
+        const auto nf = static_cast<amrex::Long>(nfail(i, j, k));
+        return {nf, static_cast<amrex::Long>(nf > 0)};
+      });
+    amrex::ParallelFor(bx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
+      if (fc(i, j, k) < 1.0) {
+        return;
+      }
+      int b = 0;
+      for (amrex::Real r = 2.0; (r <= fc(i, j, k)) && (b < CHEM_FCT_NBINS - 1);
+           r *= 2.0) {
+        b++;
+      }
+      amrex::HostDevice::Atomic::Add(&hist[b], amrex::Long(1));
+    });
+  }
+  amrex::Vector<amrex::Long> hist_h(CHEM_FCT_NBINS);
+  amrex::Gpu::copy(
+    amrex::Gpu::deviceToHost, hist_d.begin(), hist_d.end(), hist_h.begin());
+  amrex::ParallelDescriptor::ReduceLongSum(hist_h.data(), CHEM_FCT_NBINS);
+  ReduceTuple hv = reduce_data.value(reduce_op);
+  amrex::Long fails[2] = {amrex::get<0>(hv), amrex::get<1>(hv)};
+  amrex::ParallelDescriptor::ReduceLongSum(fails, 2);
+
+  amrex::Real tmin = chem_time;
+  amrex::Real tmax = chem_time;
+  amrex::Real tsum = chem_time;
+  amrex::ParallelDescriptor::ReduceRealMin(tmin);
+  amrex::ParallelDescriptor::ReduceRealMax(tmax);
+  amrex::ParallelDescriptor::ReduceRealSum(tsum);
+  const amrex::Real tmean = tsum / amrex::ParallelDescriptor::NProcs();
+
+  amrex::Print() << "... chemistry RHS evaluations per cell:" << std::endl;
+  for (int b = 0; b < CHEM_FCT_NBINS; b++) {
+    if (hist_h[b] > 0) {
+      amrex::Print() << "      [" << (1L << b) << ", ";
+      if (b < CHEM_FCT_NBINS - 1) {
+        amrex::Print() << (1L << (b + 1)) << ")";
+      } else {
+        amrex::Print() << "inf)";
+      }
+      amrex::Print() << " : " << hist_h[b] << std::endl;
+    }
+  }
+  amrex::Print() << "... failed reactor calls " << fails[0] << ", in "
+                 << fails[1] << " cells" << std::endl;
+  amrex::Print() << "... chemistry time per rank (min/mean/max) = " << tmin
+                 << " / " << tmean << " / " << tmax << ", imbalance "
+                 << ((tmean > 0.0) ? tmax / tmean : 1.0) << std::endl;
+}
@@ -0,0 +1,139 @@
+#include <algorithm>
+#include <cstdlib>
+
+#include <AMReX.H>
+#include <AMReX_BLassert.H>
+
+#include "ScratchArena.H"
+
+ScratchArena::ScratchArena() { arena_info.SetCpuMemory(); }
+
+ScratchArena::~ScratchArena()
+{
+  for (const auto& o : m_overflow) {
+    std::free(o.ptr);
+  }
+  std::free(m_buffer);
+}
+
+void*
+ScratchArena::alloc(std::size_t nbytes)
+{
+  if (nbytes == 0) {
+    return nullptr;
+  }
+  const std::size_t sz = amrex::Arena::align(nbytes);
+  void* ptr = nullptr;
+  if (m_top + sz <= m_capacity) {
+    ptr = m_buffer + m_top;
+    m_blocks.push_back({m_top, sz, true});
+    m_top += sz;
+  } else {
+    ptr = std::malloc(sz);
+    if (ptr == nullptr) {
+      amrex::Abort("ScratchArena: out of memory");
+    }
+    m_overflow.push_back({ptr, sz});
+  }
+  m_in_use += sz;
+  m_high_water = std::max(m_high_water, m_in_use);
+  return ptr;
+}
+
+void
+ScratchArena::free(void* ptr)
+{
+  if (ptr == nullptr) {
+    return;
+  }
+
+  char* p = static_cast<char*>(ptr);
+  if ((p >= m_buffer) && (p < m_buffer + m_capacity)) {
+    // Usually the last block; the others are popped once it is freed
+    for (int n = static_cast<int>(m_blocks.size()) - 1; n >= 0; n--) {
+      Block& b = m_blocks[n];
+      if (m_buffer + b.offset == p) {
+        AMREX_ASSERT(b.live);
+        b.live = false;
+        m_in_use -= b.size;
+        break;
+      }
+    }
+    while (!m_blocks.empty() && !m_blocks.back().live) {
+      m_top = m_blocks.back().offset;
+      m_blocks.pop_back();
+    }
+  } else {
+    for (auto it = m_overflow.begin(); it != m_overflow.end(); ++it) {
+      if (it->ptr == ptr) {
+        m_in_use -= it->size;
+        std::free(it->ptr);
+        m_overflow.erase(it);
+        break;
+      }
+    }
+  }
+
+  // Grow to the largest demand once nothing is handed out
+  if (m_blocks.empty() && m_overflow.empty() && (m_high_water > m_capacity)) {
+    resize_buffer(m_high_water);
+  }
+}
+
+void
+ScratchArena::reset()
+{
+  if (m_blocks.empty() && m_overflow.empty()) {
+    resize_buffer(0);
+    m_high_water = 0;
+  }
+}
+
+void
+ScratchArena::resize_buffer(std::size_t nbytes)
+{
+  AMREX_ASSERT(m_blocks.empty());
+  std::free(m_buffer);
+  m_buffer = nullptr;
+  m_capacity = 0;
+  m_top = 0;
+  if (nbytes > 0) {
+    m_buffer = static_cast<char*>(std::malloc(nbytes));
+    if (m_buffer == nullptr) {
+      amrex::Abort("ScratchArena: out of memory");
+    }
+    m_capacity = nbytes;
+  }
+}
+
+#ifndef AMREX_USE_GPU
+namespace {
+ScratchArena&
+thread_scratch_arena()
+{
+  thread_local ScratchArena arena;
+  return arena;
+}
+} // namespace
+#endif
+
+amrex::Arena*
+pc_scratch_arena()
+{
+#ifdef AMREX_USE_GPU
+  return amrex::The_Async_Arena();
+#else
+  return &thread_scratch_arena();
+#endif
+}
+
+void
+pc_reset_scratch_arenas()
+{
+#ifndef AMREX_USE_GPU
+#ifdef AMREX_USE_OMP
+#pragma omp parallel
+#endif
+  thread_scratch_arena().reset();
+#endif
+}
@@ -250,15 +250,21 @@ PeleC::variableSetUp()
 
   // Components 0:Numspec-1 are rho.omega_i
   // Component NUM_SPECIES is rho.edot = (rho.eout-rho.ein)
+  // Component NUM_SPECIES+1 is the heat release
+  // Components NUM_SPECIES+2 on are the chemistry telemetry (chem_telemetry).
+  // The number of components depends on this option, so checkpoints can
+  // only be restarted with the same value.
   store_in_checkpoint = do_react;
+  const int nreact =
+    chemTelemetryComp() + (chem_telemetry ? RCHEM_NTELEMETRY : 0);
   desc_lst.addDescriptor(
     Reactions_Type, amrex::IndexType::TheCellType(),
-    amrex::StateDescriptor::Point, 0, NUM_SPECIES + 2, interp,
-    state_data_extrap, store_in_checkpoint);
+    amrex::StateDescriptor::Point, 0, nreact, interp, state_data_extrap,
+    store_in_checkpoint);
   amrex::Vector<amrex::BCRec> bcs(NVAR);
   amrex::Vector<std::string> name(NVAR);
-  amrex::Vector<amrex::BCRec> react_bcs(NUM_SPECIES + 2);
-  amrex::Vector<std::string> react_name(NUM_SPECIES + 2);
+  amrex::Vector<amrex::BCRec> react_bcs(nreact);
+  amrex::Vector<std::string> react_name(nreact);
 
   amrex::BCRec bc;
   cnt = 0;
@@ -385,6 +391,15 @@ PeleC::variableSetUp()
   react_name[NUM_SPECIES] = "rhoe_dot";
   react_bcs[NUM_SPECIES + 1] = bc;
   react_name[NUM_SPECIES + 1] = "heatRelease";
+  if (chem_telemetry) {
+    const int tc = chemTelemetryComp();
+    for (int n = 0; n < RCHEM_NTELEMETRY; n++) {
+      react_bcs[tc + n] = bc;
+    }
+    react_name[tc] = "chemFctCount";
+    react_name[tc + 1] = "chemFailCount";
+    react_name[tc + 2] = "chemCost";
+  }
 
   amrex::StateDescriptor::BndryFunc bndryfunc2(pc_reactfill_hyp);
   bndryfunc2.setRunOnGPU(true);
@@ -680,6 +695,7 @@ PeleC::variableCleanUp()
   delete h_prob_parm_device;
   amrex::The_Arena()->free(d_prob_parm_device);
   trans_parms.deallocate();
+  chem_cache.reset();
 #ifdef PELE_USE_SPRAY
   SprayParticleContainer::SprayCleanUp();
 #endif
@@ -88,6 +88,10 @@ PeleC::fill_soot_source(
     dynamic_cast<amrex::EBFArrayBoxFactory const&>(a_state.Factory());
   auto const& flags = fact.getMultiEBCellFlagFab();
 
+  // The primitives and viscosity of the state at time are read from the
+  // cache of the stage (prim_cache) when it holds them
+  const bool use_cache = prim_cached_at(time, ng) && prim_cache_coeff;
+
   // TODO: Change to use new ParallelFor type
 #ifdef AMREX_USE_OMP
 #pragma omp parallel
@@ -104,16 +108,25 @@ PeleC::fill_soot_source(
     amrex::FArrayBox& soot_fab = a_soot_src[mfi];
     auto const& s_arr = Sfab.array();
     const int nqaux = NQAUX > 0 ? NQAUX : 1;
-    amrex::FArrayBox mu_cc(bx, 1, amrex::The_Async_Arena());
-    amrex::FArrayBox q(bx, QVAR, amrex::The_Async_Arena());
-    amrex::FArrayBox qaux(bx, nqaux, amrex::The_Async_Arena());
+    amrex::FArrayBox mu_cc;
+    amrex::FArrayBox q;
+    amrex::FArrayBox qaux;
+    if (use_cache) {
+      mu_cc = amrex::FArrayBox(prim_coeff[mfi], amrex::make_alias, dComp_mu, 1);
+      q = amrex::FArrayBox(prim_q[mfi], amrex::make_alias, 0, QVAR);
+      qaux = amrex::FArrayBox(prim_qaux[mfi], amrex::make_alias, 0, nqaux);
+    } else {
+      mu_cc.resize(bx, 1, amrex::The_Async_Arena());
+      q.resize(bx, QVAR, amrex::The_Async_Arena());
+      qaux.resize(bx, nqaux, amrex::The_Async_Arena());
+    }
     auto const& q_arr = q.array();
     auto const& qaux_arr = qaux.array();
     auto const& mu_arr = mu_cc.array();
 
     // Get primitives, Q, including (Y, T, p, rho) from conserved state
     // required for D term
-    {
+    if (!use_cache) {
       BL_PROFILE("PeleC::ctoprim()");
       amrex::ParallelFor(
         bx, [=] AMREX_GPU_DEVICE(int i, int j, int k) noexcept {
@@ -122,7 +135,7 @@ PeleC::fill_soot_source(
     }
 
     // Compute transport coefficients, coincident with Q
-    {
+    if (!use_cache) {
       auto const& qar_yin = q.array(QFS);
       auto const& qar_Tin = q.array(QTEMP);
       auto const& qar_rhoin = q.array(QRHO);
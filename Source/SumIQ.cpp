@@ -1,4 +1,5 @@
 #include <iomanip>
+#include <utility>
 
 #include "PeleC.H"
 
@@ -11,8 +12,6 @@ PeleC::sum_integrated_quantities()
     return;
   }
 
-  bool local_flag = true;
-
   int finest_level = parent->finestLevel();
   amrex::Real time = state[State_Type].curTime();
   amrex::Real mass = 0.0;
@@ -23,42 +22,50 @@ PeleC::sum_integrated_quantities()
   amrex::Real fuel_prod = 0;
   amrex::Real temp = 0;
 
-  for (int lev = 0; lev <= finest_level; lev++) {
-    PeleC& pc_lev = getLevel(lev);
-
-    mass += pc_lev.volWgtSum("density", time, local_flag);
-    mom[0] += pc_lev.volWgtSum("xmom", time, local_flag);
-    mom[1] += pc_lev.volWgtSum("ymom", time, local_flag);
-    mom[2] += pc_lev.volWgtSum("zmom", time, local_flag);
-    rho_e += pc_lev.volWgtSum("rho_e", time, local_flag);
-    rho_K += pc_lev.volWgtSum("kineng", time, local_flag);
-    rho_E += pc_lev.volWgtSum("rho_E", time, local_flag);
-
-    if (!fuel_name.empty()) {
-      fuel_prod += pc_lev.volWgtSum("rho_omega_" + fuel_name, time, local_flag);
+  // All the sums in one pass per level and one collective
+  StateReduction red;
+  const int i_mass =
+    red.add(StateReduceItem::VolSum, StateReduceItem::StateComp, URHO);
+  const int i_xmom =
+    red.add(StateReduceItem::VolSum, StateReduceItem::StateComp, UMX);
+  const int i_ymom =
+    red.add(StateReduceItem::VolSum, StateReduceItem::StateComp, UMY);
+  const int i_zmom =
+    red.add(StateReduceItem::VolSum, StateReduceItem::StateComp, UMZ);
+  const int i_rho_e =
+    red.add(StateReduceItem::VolSum, StateReduceItem::StateComp, UEINT);
+  const int i_rho_K = red.add(StateReduceItem::VolSum, StateReduceItem::KinEng);
+  const int i_rho_E =
+    red.add(StateReduceItem::VolSum, StateReduceItem::StateComp, UEDEN);
+  int i_fuel = -1;
+  if (!fuel_name.empty()) {
+    const int fuel_idx = find_position(spec_names, fuel_name);
+    if (fuel_idx < 0) {
+      amrex::Abort("Unknown species identified as fuel_name");
     }
+    i_fuel =
+      red.add(StateReduceItem::VolSum, StateReduceItem::ReactComp, fuel_idx);
+  }
+  const int i_temp =
+    red.add(StateReduceItem::VolSum, StateReduceItem::StateComp, UTEMP);
 
-    temp += pc_lev.volWgtSum("Temp", time, local_flag);
+  for (int lev = 0; lev <= finest_level; lev++) {
+    getLevel(lev).reduceState(red);
   }
 
   if (verbose > 0) {
-    const int nfoo = 10;
-    amrex::Real foo[nfoo] = {mass,  mom[0], mom[1],    mom[2], rho_e,
-                             rho_K, rho_E,  fuel_prod, temp};
-    amrex::ParallelDescriptor::ReduceRealSum(
-      foo, nfoo, amrex::ParallelDescriptor::IOProcessorNumber());
+    red.reduce(amrex::ParallelDescriptor::IOProcessorNumber());
 
     if (amrex::ParallelDescriptor::IOProcessor()) {
-      int i = 0;
-      mass = foo[i++];
-      mom[0] = foo[i++];
-      mom[1] = foo[i++];
-      mom[2] = foo[i++];
-      rho_e = foo[i++];
-      rho_K = foo[i++];
-      rho_E = foo[i++];
-      fuel_prod = foo[i++];
-      temp = foo[i++];
+      mass = red.value(i_mass);
+      mom[0] = red.value(i_xmom);
+      mom[1] = red.value(i_ymom);
+      mom[2] = red.value(i_zmom);
+      rho_e = red.value(i_rho_e);
+      rho_K = red.value(i_rho_K);
+      rho_E = red.value(i_rho_E);
+      fuel_prod = (i_fuel >= 0) ? red.value(i_fuel) : 0.0;
+      temp = red.value(i_temp);
 
       amrex::Print() << '\n';
       amrex::Print() << "TIME = " << time << " MASS        = " << mass << '\n';
@@ -130,97 +137,73 @@ PeleC::monitor_extrema()
     return;
   }
 
-  const bool local_flag = true;
   const int finest_level = parent->finestLevel();
   const amrex::Real time = state[State_Type].curTime();
   amrex::Vector<std::string> extrema_vars = {
     "density", "x_velocity", "y_velocity", "z_velocity", "eint_e",
     "Temp",    "pressure",   "massfrac",   "sumYminus1"};
 
-  int nspec_extrema = 2;
-  bool use_all_spec = false;
+  // Quantity and component of each of the extrema_vars
+  amrex::Vector<std::pair<int, int>> extrema_quantities = {
+    {StateReduceItem::StateComp, URHO},
+    {StateReduceItem::Velocity, 0},
+    {StateReduceItem::Velocity, 1},
+    {StateReduceItem::Velocity, 2},
+    {StateReduceItem::IntEnergy, 0},
+    {StateReduceItem::StateComp, UTEMP},
+    {StateReduceItem::Pressure, 0},
+    {StateReduceItem::MassFracAll, 0},
+    {StateReduceItem::SumYMinus1, 0}};
+
   if (extrema_spec_name == "ALL") {
-    use_all_spec = true;
-    nspec_extrema += NUM_SPECIES;
     extrema_vars.insert(
       extrema_vars.end(), PeleC::spec_names.begin(), PeleC::spec_names.end());
   } else {
     if (!fuel_name.empty()) {
-      nspec_extrema++;
       extrema_vars.push_back(fuel_name);
     }
     if (!flame_trac_name.empty()) {
-      nspec_extrema++;
       extrema_vars.push_back(flame_trac_name);
     }
     if (!extrema_spec_name.empty()) {
-      nspec_extrema++;
       extrema_vars.push_back(extrema_spec_name);
     }
   }
+  for (int ii = static_cast<int>(extrema_quantities.size());
+       ii < static_cast<int>(extrema_vars.size()); ++ii) {
+    extrema_quantities.emplace_back(
+      StateReduceItem::MassFrac,
+      find_position(PeleC::spec_names, extrema_vars[ii]));
+  }
 
+  // All the extrema in one pass per level and one collective
   const auto nextrema = static_cast<int>(extrema_vars.size());
-  constexpr amrex::Real neg_huge = std::numeric_limits<amrex::Real>::lowest();
-  constexpr amrex::Real huge = std::numeric_limits<amrex::Real>::max();
-  amrex::Vector<amrex::Real> minima(nextrema, huge), maxima(nextrema, neg_huge);
-
-  for (int lev = 0; lev <= finest_level; lev++) {
-    PeleC& pc_lev = getLevel(lev);
-    for (int ii = 0; ii < nextrema - nspec_extrema; ++ii) {
-      maxima[ii] = amrex::max<amrex::Real>(
-        maxima[ii], pc_lev.maxDerive(extrema_vars[ii], time, local_flag));
-      minima[ii] = amrex::min<amrex::Real>(
-        minima[ii], pc_lev.minDerive(extrema_vars[ii], time, local_flag));
+  StateReduction red;
+  amrex::Vector<int> i_min(nextrema, -1), i_max(nextrema, -1);
+  for (int ii = 0; ii < nextrema; ++ii) {
+    const auto& eq = extrema_quantities[ii];
+    if (eq.second >= 0) {
+      i_min[ii] = red.add(StateReduceItem::Min, eq.first, eq.second);
+      i_max[ii] = red.add(StateReduceItem::Max, eq.first, eq.second);
     }
+  }
 
-    // Handle species separately
-    auto mf = pc_lev.derive("massfrac", time, 0);
-    BL_ASSERT(!(mf == nullptr));
-    amrex::MultiFab sumY(pc_lev.grids, pc_lev.dmap, 1, 0);
-    sumY.setVal(0.0);
-    const auto idx_massfrac = nextrema - nspec_extrema;
-
-    for (int ispec = 0; ispec < NUM_SPECIES; ispec++) {
-      amrex::Real maxval = mf->max(ispec, 0, local_flag);
-      amrex::Real minval = mf->min(ispec, 0, local_flag);
-      amrex::MultiFab::Add(sumY, *mf, ispec, 0, 1, 0);
-
-      // "massfrac" gets the extrema across all mass fractions
-      maxima[idx_massfrac] =
-        amrex::max<amrex::Real>(maxima[idx_massfrac], maxval);
-      minima[idx_massfrac] =
-        amrex::min<amrex::Real>(minima[idx_massfrac], minval);
-
-      // Get values for any individual species if relevant
-      if (use_all_spec) {
-        const auto idx_spec = idx_massfrac + ispec + 2;
-        maxima[idx_spec] = amrex::max<amrex::Real>(maxima[idx_spec], maxval);
-        minima[idx_spec] = amrex::min<amrex::Real>(minima[idx_spec], minval);
-      } else {
-        for (int iext = 0; iext < nspec_extrema - 2; iext++) {
-          const auto idx_spec = idx_massfrac + iext + 2;
-          if (extrema_vars[idx_spec] == PeleC::spec_names[ispec]) {
-            maxima[idx_spec] =
-              amrex::max<amrex::Real>(maxima[idx_spec], maxval);
-            minima[idx_spec] =
-              amrex::min<amrex::Real>(minima[idx_spec], minval);
-          }
-        }
-      }
-    }
-    // sum of mass fractions
-    maxima[idx_massfrac + 1] = amrex::max<amrex::Real>(
-      maxima[idx_massfrac + 1], sumY.max(0, 0, local_flag) - 1.0);
-    minima[idx_massfrac + 1] = amrex::min<amrex::Real>(
-      minima[idx_massfrac + 1], sumY.min(0, 0, local_flag) - 1.0);
+  for (int lev = 0; lev <= finest_level; lev++) {
+    getLevel(lev).reduceState(red, false);
   }
 
   if (verbose > 0) {
-    amrex::ParallelDescriptor::ReduceRealMax(
-      maxima.data(), nextrema, amrex::ParallelDescriptor::IOProcessorNumber());
-
-    amrex::ParallelDescriptor::ReduceRealMin(
-      minima.data(), nextrema, amrex::ParallelDescriptor::IOProcessorNumber());
+    red.reduce(amrex::ParallelDescriptor::IOProcessorNumber());
+
+    amrex::Vector<amrex::Real> minima(nextrema), maxima(nextrema);
+    for (int ii = 0; ii < nextrema; ++ii) {
+      minima[ii] = (i_min[ii] >= 0)
+                     ? red.value(i_min[ii])
+                     : StateReduction::identity(StateReduceItem::Min);
+      maxima[ii] = (i_max[ii] >= 0)
+                     ? red.value(i_max[ii])
+                     : StateReduction::identity(StateReduceItem::Max);
+    }
 
     if (amrex::ParallelDescriptor::IOProcessor()) {
 
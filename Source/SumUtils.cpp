@@ -165,6 +165,134 @@ PeleC::minDerive(const std::string& name, amrex::Real time, bool local)
   return mf->min(0, 0, local);
 }
 
+void
+PeleC::reduceState(StateReduction& red, bool finemask)
+{
+  BL_PROFILE("PeleC::reduceState()");
+
+  const int nq = red.size();
+  if (nq == 0) {
+    return;
+  }
+
+  const amrex::MultiFab& S = get_new_data(State_Type);
+  const amrex::MultiFab& R = get_new_data(Reactions_Type);
+  const amrex::MultiFab* mask = nullptr;
+  if (finemask && (level < parent->finestLevel())) {
+    mask = &getLevel(level + 1).build_fine_mask();
+  }
+  const bool use_mask = (mask != nullptr);
+  const bool use_vfrac = eb_in_domain;
+
+  amrex::Vector<amrex::Real> init(nq);
+  for (int q = 0; q < nq; q++) {
+    init[q] = StateReduction::identity(red.items()[q].op);
+  }
+
+  // All the quantities are accumulated in the same pass. On GPUs, each block
+  // reduces its cells and adds the result atomically into acc_d. Otherwise,
+  // each thread accumulates into a private buffer.
+#ifdef AMREX_USE_GPU
+  if (amrex::Gpu::inLaunchRegion()) {
+    amrex::Gpu::DeviceVector<StateReduceItem> items_d(nq);
+    amrex::Gpu::copy(
+      amrex::Gpu::hostToDevice, red.items().begin(), red.items().end(),
+      items_d.begin());
+    const StateReduceItem* items = items_d.data();
+
+    amrex::Gpu::DeviceVector<amrex::Real> acc_d(nq);
+    amrex::Gpu::copy(
+      amrex::Gpu::hostToDevice, init.begin(), init.end(), acc_d.begin());
+    amrex::Real* acc = acc_d.data();
+
+    for (amrex::MFIter mfi(S, false); mfi.isValid(); ++mfi) {
+      const amrex::Box& bx = mfi.validbox();
+      auto const& s = S.const_array(mfi);
+      auto const& r = R.const_array(mfi);
+      auto const& vol = volume.const_array(mfi);
+      auto const& vf = use_vfrac ? vfrac.const_array(mfi)
+                                 : amrex::Array4<const amrex::Real>{};
+      auto const& m =
+        use_mask ? mask->const_array(mfi) : amrex::Array4<const amrex::Real>{};
+
+      amrex::ParallelFor(
+        amrex::Gpu::KernelInfo().setReduction(true), bx,
+        [=] AMREX_GPU_DEVICE(
+          int i, int j, int k, amrex::Gpu::Handler const& handler) noexcept {
+          amrex::Real w = vol(i, j, k);
+          if (use_vfrac) {
+            w *= vf(i, j, k);
+          }
+          if (use_mask) {
+            w *= m(i, j, k);
+          }
+          for (int q = 0; q < nq; q++) {
+            const amrex::Real v = pc_state_quantity(i, j, k, items[q], s, r);
+            if (items[q].op == StateReduceItem::Min) {
+              amrex::Gpu::deviceReduceMin(&acc[q], v, handler);
+            } else if (items[q].op == StateReduceItem::Max) {
+              amrex::Gpu::deviceReduceMax(&acc[q], v, handler);
+            } else {
+              amrex::Gpu::deviceReduceSum(&acc[q], v * w, handler);
+            }
+          }
+        });
+    }
+
+    amrex::Vector<amrex::Real> acc_h(nq);
+    amrex::Gpu::copy(
+      amrex::Gpu::deviceToHost, acc_d.begin(), acc_d.end(), acc_h.begin());
+    red.combine(acc_h.data());
+    return;
+  }
+#endif
+
+#ifdef AMREX_USE_OMP
+#pragma omp parallel
+#endif
+  {
+    amrex::Vector<amrex::Real> acc(init);
+    const StateReduceItem* items = red.items().data();
+
+    for (amrex::MFIter mfi(S, amrex::TilingIfNotGPU()); mfi.isValid();
+         ++mfi) {
+      const amrex::Box& bx = mfi.tilebox();
+      auto const& s = S.const_array(mfi);
+      auto const& r = R.const_array(mfi);
+      auto const& vol = volume.const_array(mfi);
+      auto const& vf = use_vfrac ? vfrac.const_array(mfi)
+                                 : amrex::Array4<const amrex::Real>{};
+      auto const& m =
+        use_mask ? mask->const_array(mfi) : amrex::Array4<const amrex::Real>{};
+
+      amrex::LoopOnCpu(bx, [&](int i, int j, int k) noexcept {
+        amrex::Real w = vol(i, j, k);
+        if (use_vfrac) {
+          w *= vf(i, j, k);
+        }
+        if (use_mask) {
+          w *= m(i, j, k);
+        }
+        for (int q = 0; q < nq; q++) {
+          const amrex::Real v = pc_state_quantity(i, j, k, items[q], s, r);
+          if (items[q].op == StateReduceItem::Min) {
+            acc[q] = amrex::min(acc[q], v);
+          } else if (items[q].op == StateReduceItem::Max) {
+            acc[q] = amrex::max(acc[q], v);
+          } else {
+            acc[q] += v * w;
+          }
+        }
+      });
+    }
+
+#ifdef AMREX_USE_OMP
+#pragma omp critical(pelec_reduce_state)
+#endif
+    red.combine(acc.data());
+  }
+}
+
 int
 PeleC::find_datalog_index(const std::string& logname)
 {
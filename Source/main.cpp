@@ -14,6 +14,7 @@
 
 #include "PeleC.H"
 #include "PeleCAmr.H"
+#include "Parareal.H"
 
 std::string inputs_name;
 
@@ -54,9 +55,14 @@ main(int argc, char* argv[])
     }
   }
 
+  // Ranks are split into groups running different time slices when
+  // parareal.ngroups > 1
+  MPI_Comm pelec_comm = MPI_COMM_WORLD;
+  const int time_groups =
+    PararealDriver::splitCommunicator(argc, argv, pelec_comm);
+
   // Make sure to catch new failures.
-  amrex::Initialize(
-    argc, argv, true, MPI_COMM_WORLD, override_default_parameters);
+  amrex::Initialize(argc, argv, true, pelec_comm, override_default_parameters);
 // Defined and initialized when in gnumake, but not defined in cmake and
 // initialization done manually
 #ifndef AMREX_USE_SUNDIALS
@@ -120,13 +126,16 @@ main(int argc, char* argv[])
                    << time_now.tm_mday << "." << std::endl;
   }
 
+  PararealDriver::setup();
+
   // Initialize random seed after we're running in parallel.
   auto* amrptr = new PeleCAmr(getLevelBld());
 
   amrex::AmrLevel::SetEBSupportLevel(
     amrex::EBSupport::full); // need both area and volume fractions
   amrex::AmrLevel::SetEBMaxGrowCells(
-    PeleC::numGrow() + 1, PeleC::numGrow() + 1, PeleC::numGrow() + 1);
+    PeleC::numGrowMetrics() + 1, PeleC::numGrowMetrics() + 1,
+    PeleC::numGrowMetrics() + 1);
 
   initialize_EB2(
     amrptr->Geom(PeleC::getEBMaxLevel()), PeleC::getEBMaxLevel(),
@@ -151,6 +160,12 @@ main(int argc, char* argv[])
   amrex::Real dRunTime2 = amrex::ParallelDescriptor::second();
   amrex::Real wall_time_elapsed{0.0};
 
+  // Whole parallel in time windows first, the rest in the loop below
+  if (time_groups > 1) {
+    PararealDriver parareal(*amrptr);
+    parareal.run(max_step, stop_time);
+  }
+
   while (
     (amrptr->okToContinue() != 0) &&
     (amrptr->levelSteps(0) < max_step || max_step < 0) &&
@@ -167,12 +182,16 @@ main(int argc, char* argv[])
   }
 
   // Write final checkpoint
-  if (amrptr->stepOfLastCheckPoint() < amrptr->levelSteps(0)) {
+  const bool write_output = PararealDriver::writesOutput();
+  if (
+    write_output &&
+    (amrptr->stepOfLastCheckPoint() < amrptr->levelSteps(0))) {
     amrptr->checkPoint();
   }
 
   // Write final plotfile
-  if (amrptr->stepOfLastPlotFile() < amrptr->levelSteps(0)) {
+  if (
+    write_output && (amrptr->stepOfLastPlotFile() < amrptr->levelSteps(0))) {
     amrptr->writePlotFile();
   }
 
@@ -230,6 +249,7 @@ main(int argc, char* argv[])
   amrex::sundials::Finalize();
 #endif
   amrex::Finalize();
+  PararealDriver::finalize();
 
   return 0;
 }